@@ -76,6 +76,14 @@ public:
       (*it_c)->enforce(p);
   }
   
+  //! Apply all constraints to a list of particles (e.g., all particles in a group)
+  //! \param particles list of particle indices
+  void enforce(const vector<int>& particles)
+  {
+    for (vector<ConstraintPtr>::iterator it_c = m_constraints.begin(); it_c != m_constraints.end(); it_c++)
+      (*it_c)->enforce_batch(particles);
+  }
+  
   //! Rotate director around normal vector to the surface
   void rotate_director(Particle& p, double phi)
   {
@@ -105,7 +113,7 @@ public:
   {
     Nx = 0.0; Ny = 0.0; Nz = 0.0;
     for (vector<ConstraintPtr>::iterator it_c = m_constraints.begin(); it_c != m_constraints.end(); it_c++)
-      if (find(p.groups.begin(),p.groups.end(),(*it_c)->get_group()) != p.groups.end())
+      if (p.in_group((*it_c)->get_group_id()))
       {
         double nx = 0.0, ny = 0.0, nz = 0.0;
         (*it_c)->compute_normal(p,nx,ny,nz);
@@ -115,11 +123,29 @@ public:
     Nx /= len_N;  Ny /= len_N;  Nz /= len_N;
   }
   
-  bool rescale() 
+  //! Rescale all constraints
+  //! \param affine set to true if all rescales were pure scalings of particle positions
+  //! \param sx combined scale factor along x (valid only if affine is true)
+  //! \param sy combined scale factor along y (valid only if affine is true)
+  //! \param sz combined scale factor along z (valid only if affine is true)
+  //! \return true if any of the constraints has been rescaled
+  bool rescale(bool& affine, double& sx, double& sy, double& sz) 
   {
     bool res = false;
+    affine = true;
+    sx = 1.0; sy = 1.0; sz = 1.0;
     for (vector<ConstraintPtr>::iterator it_c = m_constraints.begin(); it_c != m_constraints.end(); it_c++)
-      res = res || (*it_c)->rescale();
+      if ((*it_c)->rescale())
+      {
+        double csx, csy, csz;
+        res = true;
+        if ((*it_c)->affine_scale(csx,csy,csz))
+        {
+          sx *= csx;  sy *= csy;  sz *= csz;
+        }
+        else
+          affine = false;
+      }
     return res;
   }
   
@@ -39,34 +39,23 @@
  */
 void Constraint::enforce(Particle& p)
 {
-  bool apply = false;
-  if (m_group == "all")
-    apply = true;
-  else
-    apply = (find(p.groups.begin(),p.groups.end(),m_group) != p.groups.end());
+  bool apply = p.in_group(m_group_id);
   if (apply)
   {
-    // Compute reference gradient (SHAKE method)
-    double ref_gx, ref_gy, ref_gz;
-    this->compute_gradient(p,ref_gx, ref_gy, ref_gz);
+    // Compute reference gradient (SHAKE method); value and gradient at the 
+    // starting point are shared with the first iteration 
+    double g, gx, gy, gz;
+    this->compute_value_gradient(p, g, gx, gy, gz);
+    double ref_gx = gx, ref_gy = gy, ref_gz = gz;
     
-    bool satisfied;
     int iter = 0;
     while (iter++ < m_max_iter)
     {
-      satisfied = true;
-      // Compute unit gradient of the implicit function
-      double gx, gy, gz;
-      this->compute_gradient(p,gx,gy,gz);
+      if (fabs(g) <= m_tol) break;
       double s = gx*ref_gx + gy*ref_gy + gz*ref_gz;
-      double g = this->constraint_value(p);
       double lambda = g/s;
-      if (fabs(g) > m_tol)
-        satisfied = false;
-      if (satisfied) break;
-      p.x -= lambda*ref_gx;
-      p.y -= lambda*ref_gy;
-      p.z -= lambda*ref_gz;
+      p.move(-lambda*ref_gx, -lambda*ref_gy, -lambda*ref_gz);
+      this->compute_value_gradient(p, g, gx, gy, gz);
     }
       
     double Nx, Ny, Nz;
@@ -86,6 +75,20 @@ void Constraint::enforce(Particle& p)
   }
 }
 
+/*! Enforce constraint on all particles in the list. This is called once per 
+ *  group per time step by the integrators. Particles are independent, so the 
+ *  loop runs in parallel. Constraints with closed form projections override this 
+ *  function to avoid virtual call per particle.
+ *  \param particles list of particle indices
+ */
+void Constraint::enforce_batch(const vector<int>& particles)
+{
+  int N = particles.size();
+  #pragma omp parallel for
+  for (int i = 0; i < N; i++)
+    this->enforce(m_system->get_particle(particles[i]));
+}
+
 /*! Rotate director of a particle around the normal vector
  *  \note This function assumes that the particle has already been
  *  projected onto the surface and that its director is laying in 
@@ -95,11 +98,7 @@ void Constraint::enforce(Particle& p)
 */
 void Constraint::rotate_director(Particle& p, double phi)
 {
-  bool apply = false;
-  if (m_group == "all")
-    apply = true;
-  else
-    apply = (find(p.groups.begin(),p.groups.end(),m_group) != p.groups.end());
+  bool apply = p.in_group(m_group_id);
   if (apply)
   {
     double U, V, W;
@@ -127,11 +126,7 @@ void Constraint::rotate_director(Particle& p, double phi)
 */
 void Constraint::rotate_velocity(Particle& p, double phi)
 {
-  bool apply = false;
-  if (m_group == "all")
-    apply = true;
-  else
-    apply = (find(p.groups.begin(),p.groups.end(),m_group) != p.groups.end());
+  bool apply = p.in_group(m_group_id);
   if (apply)
   {
     double U, V, W;
@@ -157,11 +152,7 @@ void Constraint::rotate_velocity(Particle& p, double phi)
 */ 
 double Constraint::project_torque(Particle& p)
 {
-  bool apply = false;
-  if (m_group == "all")
-    apply = true;
-  else
-    apply = (find(p.groups.begin(),p.groups.end(),m_group) != p.groups.end());
+  bool apply = p.in_group(m_group_id);
   if (apply)
   {
     double Nx, Ny, Nz;
@@ -117,11 +117,15 @@ public:
       m_group = param["group"];
     }
     m_msg->write_config("constraint.group",m_group);
+    m_group_id = m_system->get_group(m_group)->get_id();
   }
   
   //! Enforce constraint
   virtual void enforce(Particle&);
   
+  //! Enforce constraint on a list of particles
+  virtual void enforce_batch(const vector<int>&);
+  
   //! Rotate director around normal vector to the surface
   virtual void rotate_director(Particle&, double);
   
@@ -140,12 +144,35 @@ public:
   // Value of the constraint
   virtual double constraint_value(Particle&) = 0;
   
+  //! Value and gradient of the constraint at a point
+  //! \note Implicit surfaces should override this if value and gradient share expensive terms
+  //! \param p particle
+  //! \param g value of the constraint (on return)
+  //! \param gx x component of the gradient (on return)
+  //! \param gy y component of the gradient (on return)
+  //! \param gz z component of the gradient (on return)
+  virtual void compute_value_gradient(Particle& p, double& g, double& gx, double& gy, double& gz)
+  {
+    g = this->constraint_value(p);
+    this->compute_gradient(p,gx,gy,gz);
+  }
+  
   // Rescale constraint
   virtual bool rescale() { return false;}
   
+  //! Scale factors of the last rescale
+  //! \param sx scale factor along x
+  //! \param sy scale factor along y
+  //! \param sz scale factor along z
+  //! \return true if the last rescale moved all particles by a pure scaling about the origin
+  virtual bool affine_scale(double& sx, double& sy, double& sz) { return false; }
+  
   //! Return the constraint group
   string get_group() { return m_group; }
   
+  //! Return the id of the constraint group
+  int get_group_id() { return m_group_id; }
+  
 protected:
   
   SystemPtr  m_system;              //!< Pointer to the system object
@@ -157,6 +184,7 @@ protected:
   int m_rescale_freq;               //!< Skip this many steps between rescaling constrain
   double m_scale;                   //!< Rescale the constraint (e.g., sphere radius) by this much in each step (=m_rescale**(m_rescale_freq/m_rescale_steps))
   string m_group;                   //!< Apply constraint only to particles in this group
+  int m_group_id;                   //!< Id of the constraint group (for fast membership tests)
   
 };
 
@@ -42,11 +42,7 @@ void ConstraintActomyo::enforce(Particle& p)
   double xlo = -0.5*m_lx, xhi = 0.5*m_lx;
   double ylo = -0.5*m_ly, yhi = 0.5*m_ly;
   
-  bool apply = false;
-  if (m_group == "all")
-    apply = true;
-  else
-    apply = (find(p.groups.begin(),p.groups.end(),m_group) != p.groups.end());
+  bool apply = p.in_group(m_group_id);
   
   if (apply)
   {
@@ -73,10 +69,10 @@ void ConstraintActomyo::enforce(Particle& p)
     // Check periodic boundary conditions 
     if (periodic)
     {
-      if (p.x <= xlo) p.x += m_lx;
-      else if (p.x >= xhi) p.x -= m_lx;
-      if (p.y <= ylo) p.y += m_ly;
-      else if (p.y >= yhi) p.y -= m_ly;
+      if (p.x <= xlo) p.move(m_lx, 0.0, 0.0);
+      else if (p.x >= xhi) p.move(-m_lx, 0.0, 0.0);
+      if (p.y <= ylo) p.move(0.0, m_ly, 0.0);
+      else if (p.y >= yhi) p.move(0.0, -m_ly, 0.0);
     }
     else // reflective boundary conditions
     {
@@ -112,11 +108,7 @@ void ConstraintActomyo::enforce(Particle& p)
 */
 void ConstraintActomyo::rotate_director(Particle& p, double phi)
 {
-  bool apply = false;
-  if (m_group == "all")
-    apply = true;
-  else
-    apply = (find(p.groups.begin(),p.groups.end(),m_group) != p.groups.end());
+  bool apply = p.in_group(m_group_id);
   if (apply)
   {
     // Sine and cosine of the rotation angle
@@ -142,11 +134,7 @@ void ConstraintActomyo::rotate_director(Particle& p, double phi)
 */
 void ConstraintActomyo::rotate_velocity(Particle& p, double phi)
 {
-  bool apply = false;
-  if (m_group == "all")
-    apply = true;
-  else
-    apply = (find(p.groups.begin(),p.groups.end(),m_group) != p.groups.end());
+  bool apply = p.in_group(m_group_id);
   if (apply)
   {
     // Sine and cosine of the rotation angle
@@ -170,11 +158,7 @@ void ConstraintActomyo::rotate_velocity(Particle& p, double phi)
 */ 
 double ConstraintActomyo::project_torque(Particle& p)
 {
-  bool apply = false;
-  if (m_group == "all")
-    apply = true;
-  else
-    apply = (find(p.groups.begin(),p.groups.end(),m_group) != p.groups.end());
+  bool apply = p.in_group(m_group_id);
   if (apply)
     return p.tau_z;  
   else
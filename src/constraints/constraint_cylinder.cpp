@@ -37,11 +37,7 @@
  */
 void ConstraintCylinder::enforce(Particle& p)
 {
-  bool apply = false;
-  if (m_group == "all")
-    apply = true;
-  else
-    apply = (find(p.groups.begin(),p.groups.end(),m_group) != p.groups.end());
+  bool apply = p.in_group(m_group_id);
   if (apply)
   {
     bool periodic = m_system->get_periodic();
@@ -66,8 +62,8 @@ void ConstraintCylinder::enforce(Particle& p)
     p.nx *= inv_len;  p.ny *= inv_len;  p.nz *= inv_len;
     if (periodic)
     {
-      if (p.z > box->zhi) p.z -= box->Lz;
-      else if (p.z < box->zlo) p.z += box->Lz;
+      if (p.z > box->zhi) p.move(0.0, 0.0, -box->Lz);
+      else if (p.z < box->zlo) p.move(0.0, 0.0, box->Lz);
     }
   }
 }
@@ -94,3 +90,28 @@ bool ConstraintCylinder::rescale()
   }
   return false;
 }
+
+/*! Radial projection onto the rescaled cylinder is a scaling of x and y 
+ *  coordinates of all particles that are on the cylinder. This holds only if 
+ *  the constraint is applied to all particles.
+ *  \param sx scale factor along x
+ *  \param sy scale factor along y
+ *  \param sz scale factor along z
+ */
+bool ConstraintCylinder::affine_scale(double& sx, double& sy, double& sz)
+{
+  sx = m_scale;  sy = m_scale;  sz = 1.0;
+  return (m_group_id == m_system->get_group("all")->get_id());
+}
+
+/*! Enforce constraint on all particles in the list. Projection is exact (radial projection),
+ *  so there is no iteration and the non-virtual call can be inlined.
+ *  \param particles list of particle indices
+ */
+void ConstraintCylinder::enforce_batch(const vector<int>& particles)
+{
+  int N = particles.size();
+  #pragma omp parallel for
+  for (int i = 0; i < N; i++)
+    ConstraintCylinder::enforce(m_system->get_particle(particles[i]));
+}
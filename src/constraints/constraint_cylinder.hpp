@@ -72,6 +72,9 @@ public:
   //! Enforce constraint
   void enforce(Particle&);
   
+  //! Enforce constraint on a list of particles (closed form)
+  void enforce_batch(const vector<int>&);
+  
   //! Computes normal to the surface
   void compute_normal(Particle& p, double& Nx, double& Ny, double& Nz)
   { 
@@ -87,6 +90,9 @@ public:
   
   // Rescale constraint
   bool rescale();
+  
+  //! Scale factors of the last rescale
+  bool affine_scale(double&, double&, double&);
       
 private:
   
@@ -60,12 +60,8 @@ void ConstraintGyroid::compute_normal(Particle& p, double& Nx, double& Ny, doubl
 */
 void ConstraintGyroid::compute_gradient(Particle&p, double& gx, double& gy, double& gz)
 {
-  double x = p.x, y = p.y, z = p.z;
-  BoxPtr box = m_system->get_box();
-  double lx = box->Lx, ly = box->Ly, lz = box->Lz;
-  gx = (2*M_PI*(cos((2*M_PI*x)/lx)*cos((2*M_PI*z)/lz) - sin((2*M_PI*x)/lx)*sin((2*M_PI*y)/ly)))/lx;
-  gy = (2*M_PI*(cos((2*M_PI*x)/lx)*cos((2*M_PI*y)/ly) - sin((2*M_PI*y)/ly)*sin((2*M_PI*z)/lz)))/ly;
-  gz = (2*M_PI*(cos((2*M_PI*y)/ly)*cos((2*M_PI*z)/lz) - sin((2*M_PI*x)/lx)*sin((2*M_PI*z)/lz)))/lz;
+  double g;
+  this->compute_value_gradient(p, g, gx, gy, gz);
 }
 
 /*! Compute constraint value at particle p
@@ -79,3 +75,24 @@ double ConstraintGyroid::constraint_value(Particle& p)
   return cos((2*M_PI*z)/lz)*sin((2*M_PI*x)/lx) + cos((2*M_PI*x)/lx)*sin((2*M_PI*y)/ly) + cos((2*M_PI*y)/ly)*sin((2*M_PI*z)/lz);
 }
 
+/*! Compute constraint value and its gradient at particle p. 
+ *  Sines and cosines of the three coordinates are evaluated only once 
+ *  and shared between the value and all three components of the gradient.
+ *  \param p reference to the particle
+ *  \param g value of the constraint (on return)
+ *  \param gx x component of the gradient (on return)
+ *  \param gy y component of the gradient (on return)
+ *  \param gz z component of the gradient (on return)
+*/
+void ConstraintGyroid::compute_value_gradient(Particle& p, double& g, double& gx, double& gy, double& gz)
+{
+  BoxPtr box = m_system->get_box();
+  double kx = 2*M_PI/box->Lx, ky = 2*M_PI/box->Ly, kz = 2*M_PI/box->Lz;
+  double sx = sin(kx*p.x), cx = cos(kx*p.x);
+  double sy = sin(ky*p.y), cy = cos(ky*p.y);
+  double sz = sin(kz*p.z), cz = cos(kz*p.z);
+  g = cz*sx + cx*sy + cy*sz;
+  gx = kx*(cx*cz - sx*sy);
+  gy = ky*(cx*cy - sy*sz);
+  gz = kz*(cy*cz - sx*sz);
+}
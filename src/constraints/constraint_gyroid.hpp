@@ -68,6 +68,9 @@ public:
   
   // Value of the constraint
   double constraint_value(Particle&); 
+  
+  //! Value and gradient of the constraint (shares trigonometric terms)
+  void compute_value_gradient(Particle&, double&, double&, double&, double&);
     
   
 };
@@ -35,11 +35,7 @@
  */
 void ConstraintPlane::enforce(Particle& p)
 {
-  bool apply = false;
-  if (m_group == "all")
-    apply = true;
-  else
-    apply = (find(p.groups.begin(),p.groups.end(),m_group) != p.groups.end());
+  bool apply = p.in_group(m_group_id);
   if (apply)
   {
     bool periodic = m_system->get_periodic();
@@ -96,7 +92,7 @@ void ConstraintPlane::enforce(Particle& p)
 */
 void ConstraintPlane::rotate_director(Particle& p, double phi)
 {
-  if (find(p.groups.begin(),p.groups.end(),m_group) != p.groups.end())
+  if (p.in_group(m_group_id))
   {
     // Sine and cosine of the rotation angle
     double c = cos(phi), s = sin(phi);
@@ -121,11 +117,7 @@ void ConstraintPlane::rotate_director(Particle& p, double phi)
 */
 void ConstraintPlane::rotate_velocity(Particle& p, double phi)
 {
-  bool apply = false;
-  if (m_group == "all")
-    apply = true;
-  else
-    apply = (find(p.groups.begin(),p.groups.end(),m_group) != p.groups.end());
+  bool apply = p.in_group(m_group_id);
   if (apply)
   {
     // Sine and cosine of the rotation angle
@@ -149,11 +141,7 @@ void ConstraintPlane::rotate_velocity(Particle& p, double phi)
 */ 
 double ConstraintPlane::project_torque(Particle& p)
 {
-  bool apply = false;
-  if (m_group == "all")
-    apply = true;
-  else
-    apply = (find(p.groups.begin(),p.groups.end(),m_group) != p.groups.end());
+  bool apply = p.in_group(m_group_id);
   
   if (apply)
     return p.tau_z;  
@@ -187,3 +175,27 @@ bool ConstraintPlane::rescale()
   return false;
 }
 
+/*! Plane rescale scales the box and all particle positions. Projection back 
+ *  onto the plane (and the box boundaries) does not change this as long as the plane 
+ *  passes through the origin and the constraint is applied to all particles. 
+ *  \param sx scale factor along x
+ *  \param sy scale factor along y
+ *  \param sz scale factor along z
+ */
+bool ConstraintPlane::affine_scale(double& sx, double& sy, double& sz)
+{
+  sx = m_scale;  sy = m_scale;  sz = m_scale;
+  return (m_zpos == 0.0 && m_group_id == m_system->get_group("all")->get_id());
+}
+
+/*! Enforce constraint on all particles in the list. Projection is exact (projection onto the plane),
+ *  so there is no iteration and the non-virtual call can be inlined.
+ *  \param particles list of particle indices
+ */
+void ConstraintPlane::enforce_batch(const vector<int>& particles)
+{
+  int N = particles.size();
+  #pragma omp parallel for
+  for (int i = 0; i < N; i++)
+    ConstraintPlane::enforce(m_system->get_particle(particles[i]));
+}
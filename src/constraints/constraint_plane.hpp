@@ -83,6 +83,9 @@ public:
   //! Enforce constraint
   void enforce(Particle&);
   
+  //! Enforce constraint on a list of particles (closed form)
+  void enforce_batch(const vector<int>&);
+  
   //! Rotate director around normal vector to the plane (z axis)
   void rotate_director(Particle&, double);
   
@@ -103,6 +106,9 @@ public:
   
   // Rescale constraint
   bool rescale();
+  
+  //! Scale factors of the last rescale
+  bool affine_scale(double&, double&, double&);
    
 private:
   
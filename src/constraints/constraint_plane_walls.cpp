@@ -37,11 +37,7 @@
  */
 void ConstraintPlaneWalls::enforce(Particle& p)
 {
-  bool apply = false;
-  if (m_group == "all")
-    apply = true;
-  else
-    apply = (find(p.groups.begin(),p.groups.end(),m_group) != p.groups.end());
+  bool apply = p.in_group(m_group_id);
   if (apply)
   {
     bool periodic = m_system->get_periodic();
@@ -53,8 +49,8 @@ void ConstraintPlaneWalls::enforce(Particle& p)
     // Check periodic boundary conditions 
     if (periodic)
     {
-      if (p.y <= ylo) p.y += ly;
-      else if (p.y >= yhi) p.y -= ly;
+      if (p.y <= ylo) p.move(0.0, ly, 0.0);
+      else if (p.y >= yhi) p.move(0.0, -ly, 0.0);
     }
     if (p.x >= m_l)
     {
@@ -77,11 +73,7 @@ void ConstraintPlaneWalls::enforce(Particle& p)
 */
 void ConstraintPlaneWalls::rotate_director(Particle& p, double phi)
 {
-  bool apply = false;
-  if (m_group == "all")
-    apply = true;
-  else
-    apply = (find(p.groups.begin(),p.groups.end(),m_group) != p.groups.end());
+  bool apply = p.in_group(m_group_id);
   if (apply)
   {
     // Sine and cosine of the rotation angle
@@ -107,11 +99,7 @@ void ConstraintPlaneWalls::rotate_director(Particle& p, double phi)
 */
 void ConstraintPlaneWalls::rotate_velocity(Particle& p, double phi)
 {
-  bool apply = false;
-  if (m_group == "all")
-    apply = true;
-  else
-    apply = (find(p.groups.begin(),p.groups.end(),m_group) != p.groups.end());
+  bool apply = p.in_group(m_group_id);
   if (apply)
   {
     // Sine and cosine of the rotation angle
@@ -135,11 +123,7 @@ void ConstraintPlaneWalls::rotate_velocity(Particle& p, double phi)
 */ 
 double ConstraintPlaneWalls::project_torque(Particle& p)
 {
-  bool apply = false;
-  if (m_group == "all")
-    apply = true;
-  else
-    apply = (find(p.groups.begin(),p.groups.end(),m_group) != p.groups.end());
+  bool apply = p.in_group(m_group_id);
   
   if (apply)
     return p.tau_z;  
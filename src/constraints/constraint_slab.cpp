@@ -34,11 +34,7 @@
  */
 void ConstraintSlab::enforce(Particle& p)
 {
-  bool apply = false;
-  if (m_group == "all")
-    apply = true;
-  else
-    apply = (find(p.groups.begin(),p.groups.end(),m_group) != p.groups.end());
+  bool apply = p.in_group(m_group_id);
   if (apply)
   {
     if (p.z < m_z_lo)
@@ -58,5 +54,14 @@ void ConstraintSlab::enforce(Particle& p)
     m_system->enforce_periodic(p);
 }
 
-
-
+/*! Enforce constraint on all particles in the list. Projection is exact (reflection from the walls),
+ *  so there is no iteration and the non-virtual call can be inlined.
+ *  \param particles list of particle indices
+ */
+void ConstraintSlab::enforce_batch(const vector<int>& particles)
+{
+  int N = particles.size();
+  #pragma omp parallel for
+  for (int i = 0; i < N; i++)
+    ConstraintSlab::enforce(m_system->get_particle(particles[i]));
+}
@@ -81,6 +81,9 @@ public:
   //! Enforce constraint
   void enforce(Particle&);
   
+  //! Enforce constraint on a list of particles (closed form)
+  void enforce_batch(const vector<int>&);
+  
   //! Rotate director around normal vector to the slab (z axis)
   void rotate_director(Particle& p, double phi) { }  // Does not do anything as this is not really a surface constraint.
   
@@ -37,11 +37,7 @@
  */
 void ConstraintSphere::enforce(Particle& p)
 {
-  bool apply = false;
-  if (m_group == "all")
-    apply = true;
-  else
-    apply = (find(p.groups.begin(),p.groups.end(),m_group) != p.groups.end());
+  bool apply = p.in_group(m_group_id);
   if (apply)
   {
     double x = p.x, y = p.y, z = p.z;
@@ -103,3 +99,27 @@ bool ConstraintSphere::rescale()
   return false;
 }
 
+/*! Radial projection onto the rescaled sphere is a uniform scaling of all 
+ *  particles that are on the sphere. This holds only if the constraint is applied 
+ *  to all particles.
+ *  \param sx scale factor along x
+ *  \param sy scale factor along y
+ *  \param sz scale factor along z
+ */
+bool ConstraintSphere::affine_scale(double& sx, double& sy, double& sz)
+{
+  sx = m_scale;  sy = m_scale;  sz = m_scale;
+  return (m_group_id == m_system->get_group("all")->get_id());
+}
+
+/*! Enforce constraint on all particles in the list. Projection is exact (radial projection),
+ *  so there is no iteration and the non-virtual call can be inlined.
+ *  \param particles list of particle indices
+ */
+void ConstraintSphere::enforce_batch(const vector<int>& particles)
+{
+  int N = particles.size();
+  #pragma omp parallel for
+  for (int i = 0; i < N; i++)
+    ConstraintSphere::enforce(m_system->get_particle(particles[i]));
+}
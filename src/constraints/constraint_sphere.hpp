@@ -72,6 +72,9 @@ public:
   //! Enforce constraint
   void enforce(Particle&);
   
+  //! Enforce constraint on a list of particles (closed form)
+  void enforce_batch(const vector<int>&);
+  
   //! Computes normal to the surface
   void compute_normal(Particle& p, double& Nx, double& Ny, double& Nz) { Nx = p.x/m_r; Ny = p.y/m_r; Nz = p.z/m_r; p.Nx = Nx; p.Ny = Ny; p.Nz = Nz; }
   
@@ -83,6 +86,9 @@ public:
   
   // Rescale constraint
   bool rescale();
+  
+  //! Scale factors of the last rescale
+  bool affine_scale(double&, double&, double&);
       
 private:
   
@@ -29,6 +29,9 @@
 
 #include "dump.hpp"
 
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
 //! Simple helper function to write an integer.
 /*! 
  *  \param file file to write to
@@ -60,7 +63,12 @@ Dump::Dump(SystemPtr sys, MessengerPtr msg, NeighbourListPtr nlist, const string
                                                                                                                   m_include_bonds(false),
                                                                                                                   m_include_mesh(false), 
                                                                                                                   m_group("all"),
-                                                                                                                  m_directory(".")
+                                                                                                                  m_directory("."),
+                                                                                                                  m_async(false),
+                                                                                                                  m_queue_depth(2),
+                                                                                                                  m_stop(false),
+                                                                                                                  m_frames(0),
+                                                                                                                  m_stall_time(0.0)
 {
   m_type_ext["velocity"] = "vel";
   m_type_ext["xyz"] = "xyz";
@@ -344,6 +352,46 @@ Dump::Dump(SystemPtr sys, MessengerPtr msg, NeighbourListPtr nlist, const string
       }
     }
   }
+  
+  if (params.find("async") != params.end())
+  {
+    if (this->staged())
+    {
+      m_async = true;
+      if (params.find("queue_depth") != params.end())
+      {
+        m_queue_depth = lexical_cast<int>(params["queue_depth"]);
+        if (m_queue_depth < 1)
+        {
+          m_msg->msg(Messenger::ERROR,"Dump queue depth has to be at least 1.");
+          throw runtime_error("Illegal dump queue depth.");
+        }
+      }
+      m_msg->msg(Messenger::INFO,"Dump will be written by a background thread with at most "+lexical_cast<string>(m_queue_depth)+" frames in flight.");
+      m_msg->write_config("dump."+fname+".async","true");
+      m_msg->write_config("dump."+fname+".queue_depth",lexical_cast<string>(m_queue_depth));
+      m_writer = boost::thread(boost::bind(&Dump::write_loop, this));
+    }
+    else
+      m_msg->msg(Messenger::WARNING,"Asynchronous output is only supported for xyz, full, mol2 and face dumps. Dump type "+m_type+" will be written synchronously.");
+  }
+}
+
+//! Stop the writer thread (after it has written all queued frames) and close the file
+Dump::~Dump()
+{
+  if (m_writer.joinable())
+  {
+    {
+      boost::lock_guard<boost::mutex> lock(m_queue_mutex);
+      m_stop = true;
+    }
+    m_not_empty.notify_one();
+    m_writer.join();
+  }
+  if (!m_multi_print) m_file.close();
+  m_type_ext.clear();
+  m_to_print.clear();
 }
 
 //! Do actual dump.
@@ -354,6 +402,23 @@ void Dump::dump(int step)
     return;
   if (step % m_freq != 0)
     return;
+  if (this->staged())
+  {
+    DumpFramePtr frame = boost::make_shared<DumpFrame>();
+    frame->step = step;
+    if (m_multi_print)
+    {
+      frame->file_name = m_directory+"/"+m_file_name+"_"+lexical_cast<string>(format("%010d") % (step+m_time_step_offset))+"."+m_ext;
+      if (m_compress)
+        frame->file_name += ".gz";
+    }
+    this->stage(*frame);
+    if (m_async)
+      this->submit(frame);
+    else
+      this->write_frame(*frame);
+    return;
+  }
   if (m_multi_print)
   {
     string file_name = m_directory+"/"+m_file_name+"_"+lexical_cast<string>(format("%010d") % (step+m_time_step_offset))+"."+m_ext;
@@ -372,11 +437,7 @@ void Dump::dump(int step)
       m_out.push(m_file);
   }
   
-  if (m_type == "xyz")
-    this->dump_xyz();
-  else if (m_type == "full")
-    this->dump_data();
-  else if (m_type == "input")
+  if (m_type == "input")
     this->dump_input();
   else if (m_type == "velocity")
     this->dump_velocity();
@@ -388,12 +449,8 @@ void Dump::dump(int step)
     this->dump_xyzv();
   else if (m_type == "xyzc")
     this->dump_xyzc();
-  else if (m_type == "mol2")
-    this->dump_mol2();
   else if (m_type == "contact")
     this->dump_contact();
-  else if (m_type == "face")
-    this->dump_faces();
   else if (m_type == "mesh")
     this->dump_mesh();
   else if (m_type == "boundary")
@@ -413,8 +470,195 @@ void Dump::dump(int step)
     }
 }
 
+/*! Wait until the writer thread has written all queued frames and report
+ *  how long the simulation waited for it since the last report.
+ */
+void Dump::finish()
+{
+  if (!m_async)
+    return;
+  int frames;
+  double stall_time;
+  string error;
+  {
+    boost::unique_lock<boost::mutex> lock(m_queue_mutex);
+    while (!m_queue.empty())
+      m_not_full.wait(lock);
+    frames = m_frames;
+    stall_time = m_stall_time;
+    error = m_error;
+    m_frames = 0;
+    m_stall_time = 0.0;
+    m_error = "";
+  }
+  if (error != "")
+    m_msg->msg(Messenger::WARNING,"Writing dump "+m_file_name+" failed: "+error);
+  m_msg->msg(Messenger::INFO,"Dump "+m_file_name+" wrote "+lexical_cast<string>(frames)+" frames in the background. Simulation waited "+lexical_cast<string>(stall_time)+" s for the writer.");
+}
+
 // Private functions 
 
+/*! Copy the data needed by the current dump type into a frame.
+ *  This is the only part of a staged dump that runs on the simulation thread.
+ *  \param frame frame to fill (step and file name are already set)
+ */
+void Dump::stage(DumpFrame& frame)
+{
+  frame.Lx = m_system->get_box()->Lx;
+  frame.Ly = m_system->get_box()->Ly;
+  frame.Lz = m_system->get_box()->Lz;
+  frame.has_faces = m_nlist && m_nlist->has_faces();
+  frame.has_contacts = m_nlist && m_nlist->has_contacts();
+  if (m_type == "face")
+  {
+    if (!m_nlist)
+    {
+      m_msg->msg(Messenger::ERROR,"In order to produce faces based on the contact network you need to specify neighbour list. Please use nlist command.");
+      throw runtime_error("No neighbour list specified for faces dump.");
+    }
+    if (frame.has_faces)
+    {
+      vector<Face>& faces = m_system->get_mesh().get_faces();
+      frame.face_ids.resize(faces.size());
+      frame.face_vertices.resize(faces.size());
+      for (unsigned int i = 0; i < faces.size(); i++)
+      {
+        frame.face_ids[i] = faces[i].id;
+        frame.face_vertices[i] = faces[i].vertices;
+      }
+    }
+    return;
+  }
+  if (m_type == "mol2")
+  {
+    int Nbonds = m_system->num_bonds();
+    frame.bonds.reserve(Nbonds);
+    for (int i = 0; i < Nbonds; i++)
+      frame.bonds.push_back(m_system->get_bond(i));
+  }
+  // MOL2 output does not support groups
+  bool all = (m_type == "mol2");
+  int N = all ? m_system->size() : m_system->get_group(m_group)->get_size();
+  const vector<int>& particles = m_system->get_group(m_group)->get_particles();
+  Mesh& mesh = m_system->get_mesh();
+  frame.particles.resize(N);
+  for (int i = 0; i < N; i++)
+  {
+    Particle& p = m_system->get_particle(all ? i : particles[i]);
+    DumpParticle& d = frame.particles[i];
+    d.id = p.get_id();  d.type = p.get_type();  d.flag = p.get_flag();  d.parent = p.get_parent();
+    d.molecule = p.molecule;
+    d.ix = p.ix;  d.iy = p.iy;  d.iz = p.iz;
+    d.radius = p.get_radius();
+    d.x = p.x;  d.y = p.y;  d.z = p.z;
+    d.vx = p.vx;  d.vy = p.vy;  d.vz = p.vz;
+    d.fx = p.fx;  d.fy = p.fy;  d.fz = p.fz;
+    d.nx = p.nx;  d.ny = p.ny;  d.nz = p.nz;
+    d.Nx = p.Nx;  d.Ny = p.Ny;  d.Nz = p.Nz;
+    d.omega = p.omega;
+    d.A0 = p.A0;
+    d.boundary = p.boundary;
+    d.in_tissue = p.in_tissue;
+    d.cont_num = frame.has_contacts ? m_nlist->get_contacts(i).size() : 0;
+    if (frame.has_faces)
+    {
+      Vertex& V = mesh.get_vertices()[p.get_id()];
+      d.area = V.area;
+      d.perim = V.perim;
+    }
+    else
+    {
+      d.area = 0.0;
+      d.perim = 0.0;
+    }
+  }
+}
+
+/*! Format frame and write it to the output file. 
+ *  For asynchronous dumps this runs in the writer thread, so it 
+ *  must not touch the system or send messages.
+ *  \param frame frame to write
+ */
+void Dump::write_frame(const DumpFrame& frame)
+{
+  if (m_multi_print)
+  {
+    if (m_compress)
+      m_file.open(frame.file_name.c_str(),std::ios_base::out | std::ios_base::binary);
+    else
+      m_file.open(frame.file_name.c_str());
+    m_out.push(m_file);
+  }
+  
+  if (m_type == "xyz")
+    this->dump_xyz(frame);
+  else if (m_type == "full")
+    this->dump_data(frame);
+  else if (m_type == "mol2")
+    this->dump_mol2(frame);
+  else if (m_type == "face")
+    this->dump_faces(frame);
+  
+  if (m_multi_print)
+  {
+    m_out.pop();
+    m_file.close();
+  }
+}
+
+/*! Hand frame over to the writer thread. If queue_depth frames 
+ *  are already in flight, wait until the writer finishes one of them.
+ *  \param frame frame to write
+ */
+void Dump::submit(DumpFramePtr frame)
+{
+  boost::unique_lock<boost::mutex> lock(m_queue_mutex);
+  if (static_cast<int>(m_queue.size()) >= m_queue_depth)
+  {
+    boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+    while (static_cast<int>(m_queue.size()) >= m_queue_depth)
+      m_not_full.wait(lock);
+    m_stall_time += (boost::posix_time::microsec_clock::universal_time() - start).total_microseconds()*1e-6;
+  }
+  m_queue.push_back(frame);
+  m_not_empty.notify_one();
+}
+
+//! Main loop of the writer thread. Writes frames in the order they were submitted until told to stop.
+void Dump::write_loop()
+{
+  for (;;)
+  {
+    DumpFramePtr frame;
+    {
+      boost::unique_lock<boost::mutex> lock(m_queue_mutex);
+      while (m_queue.empty() && !m_stop)
+        m_not_empty.wait(lock);
+      if (m_queue.empty())
+        return;
+      frame = m_queue.front();
+    }
+    string error;
+    try
+    {
+      this->write_frame(*frame);
+    }
+    catch (std::exception& e)
+    {
+      error = e.what();
+    }
+    {
+      boost::lock_guard<boost::mutex> lock(m_queue_mutex);
+      // Frame leaves the queue only once written, so that finish() knows when all output is on the disk
+      m_queue.pop_front();
+      m_frames++;
+      if (error != "" && m_error == "")
+        m_error = error;
+    }
+    m_not_full.notify_all();
+  }
+}
+
 //! Dump coordinated in a DCD file
 void Dump::dump_dcd()
 {
@@ -487,28 +731,27 @@ void Dump::dump_dcd()
 }
 
 //! Dump particle coordinates in the common XYZ format
-void Dump::dump_xyz()
+//! \param frame staged frame
+void Dump::dump_xyz(const DumpFrame& frame)
 {
-  int N = m_system->get_group(m_group)->get_size();
-  vector<int> particles = m_system->get_group(m_group)->get_particles();
+  int N = frame.particles.size();
   m_out << N << endl;
   m_out << "Generated by SAMoS code." << endl;
   for (int i = 0; i < N; i++)
   {
-    Particle& p = m_system->get_particle(particles[i]);
-    m_out << format("%3d\t%10.6f\t%10.6f\t%10.6f") % p.get_type() % p.x % p.y % p.z << endl;
+    const DumpParticle& p = frame.particles[i];
+    m_out << format("%3d\t%10.6f\t%10.6f\t%10.6f") % p.type % p.x % p.y % p.z << endl;
   }
 }
 
 //! Dump selected set of data
-void Dump::dump_data()
+//! \param frame staged frame
+void Dump::dump_data(const DumpFrame& frame)
 {
-  double Lx = m_system->get_box()->Lx;
-  double Ly = m_system->get_box()->Ly;
-  double Lz = m_system->get_box()->Lz;
-  int N = m_system->get_group(m_group)->get_size();
-  vector<int> particles = m_system->get_group(m_group)->get_particles();
-  Mesh& mesh = m_system->get_mesh();
+  double Lx = frame.Lx;
+  double Ly = frame.Ly;
+  double Lz = frame.Lz;
+  int N = frame.particles.size();
   if (m_print_header)
   {
     m_out << "# ";
@@ -599,16 +842,15 @@ void Dump::dump_data()
   }
   for (int i = 0; i < N; i++)
   {
-    Particle& p = m_system->get_particle(particles[i]);
-    Vertex& V = mesh.get_vertices()[p.get_id()];
+    const DumpParticle& p = frame.particles[i];
     if (m_params.find("id") != m_params.end())
-      m_out << format("%5d ") % p.get_id();
+      m_out << format("%5d ") % p.id;
     if (m_params.find("tp") != m_params.end())
-      m_out << format("%2d ") % p.get_type();
+      m_out << format("%2d ") % p.type;
     if (m_params.find("flag") != m_params.end())
-      m_out << format("%5d ") % p.get_flag();
+      m_out << format("%5d ") % p.flag;
     if (m_params.find("radius") != m_params.end())
-      m_out << format("%8.5f ") % p.get_radius();
+      m_out << format("%8.5f ") % p.radius;
     if (m_params.find("coordinate") != m_params.end())
     {
       if (m_params.find("unwrap") != m_params.end())
@@ -629,23 +871,23 @@ void Dump::dump_data()
     if (m_params.find("normal") != m_params.end())
       m_out << format(" %10.6f  %10.6f  %10.6f") % p.Nx % p.Ny % p.Nz;
     if (m_params.find("parent") != m_params.end())
-      m_out << format(" %3d ") % p.get_parent();
+      m_out << format(" %3d ") % p.parent;
     if (m_params.find("area") != m_params.end())
       m_out << format("%10.6f ") % p.A0;
     if (m_params.find("cell_area") != m_params.end())
     {
-        if (m_nlist->has_faces())
-          m_out << format("%10.6f ") % V.area;
+        if (frame.has_faces)
+          m_out << format("%10.6f ") % p.area;
     }
     if (m_params.find("cell_perim") != m_params.end())
     {
-        if (m_nlist->has_faces())
-        m_out << format("%10.6f ") % V.perim;
+        if (frame.has_faces)
+        m_out << format("%10.6f ") % p.perim;
     }
     if (m_params.find("cont_num") != m_params.end())
     {
-        if (m_nlist->has_contacts())
-          m_out << format("%2d ") % m_nlist->get_contacts(i).size();
+        if (frame.has_contacts)
+          m_out << format("%2d ") % p.cont_num;
     }
     if (m_params.find("boundary") != m_params.end())
     {
@@ -665,8 +907,8 @@ void Dump::dump_data()
       m_out << format("%2d ") % p.molecule;
     if (m_params.find("shape_param") != m_params.end())
     {
-      if (m_nlist->has_faces())
-        m_out << format("%10.6f ") % (V.perim/sqrt(V.area));
+      if (frame.has_faces)
+        m_out << format("%10.6f ") % (p.perim/sqrt(p.area));
     }
     m_out << endl;
   }
@@ -676,7 +918,7 @@ void Dump::dump_data()
 void Dump::dump_input()
 {
   int N = m_system->get_group(m_group)->get_size();
-  vector<int> particles = m_system->get_group(m_group)->get_particles();
+  const vector<int>& particles = m_system->get_group(m_group)->get_particles();
   if (m_print_header)
   {
     m_out << "# " << format(" Lx = %10.6f, Ly = %10.6f, Lz = %10.6f") % m_system->get_box()->Lx % m_system->get_box()->Ly % m_system->get_box()->Lz << endl;
@@ -697,7 +939,7 @@ void Dump::dump_velocity()
 {
   double scale = 1.0;
   int N = m_system->get_group(m_group)->get_size();
-  vector<int> particles = m_system->get_group(m_group)->get_particles();
+  const vector<int>& particles = m_system->get_group(m_group)->get_particles();
   if (m_params.find("scale") != m_params.end())
   {
     m_msg->msg(Messenger::INFO,"Scaling all velocities by "+m_params["scale"]+".");
@@ -721,7 +963,7 @@ void Dump::dump_director()
 {
   double scale = 1.0;
   int N = m_system->get_group(m_group)->get_size();
-  vector<int> particles = m_system->get_group(m_group)->get_particles();
+  const vector<int>& particles = m_system->get_group(m_group)->get_particles();
   if (m_params.find("scale") != m_params.end())
   {
     m_msg->msg(Messenger::INFO,"Scaling all director vectors by "+m_params["scale"]+".");
@@ -745,7 +987,7 @@ void Dump::dump_xyzv()
 {
   double scale = 1.0;
   int N = m_system->get_group(m_group)->get_size();
-  vector<int> particles = m_system->get_group(m_group)->get_particles();
+  const vector<int>& particles = m_system->get_group(m_group)->get_particles();
   if (m_params.find("scale") != m_params.end())
   {
 #ifndef NDEBUG
@@ -773,7 +1015,7 @@ void Dump::dump_xyzv()
 void Dump::dump_xyzc()
 {
   int N = m_system->get_group(m_group)->get_size();
-  vector<int> particles = m_system->get_group(m_group)->get_particles();
+  const vector<int>& particles = m_system->get_group(m_group)->get_particles();
   m_system->enable_per_particle_eng();
   m_msg->msg(Messenger::WARNING,"XYZC file format output enabled per particle energy tracking. There fill be a substantial performance penalty (using slow STL maps).");
   m_out << N << endl;
@@ -798,10 +1040,11 @@ void Dump::dump_xyzc()
 
 //! Dump particle coordinates and bonds in the common MOL2 format
 //! suitable for visualization with VMD
-void Dump::dump_mol2()
+//! \param frame staged frame
+void Dump::dump_mol2(const DumpFrame& frame)
 {
-  int N = m_system->size();
-  int Nbonds = m_system->num_bonds();
+  int N = frame.particles.size();
+  int Nbonds = frame.bonds.size();
   m_out << "@<TRIPOS>MOLECULE" << endl;
   m_out << "Generated by SAMoS code" << endl;
   m_out << N << "  " << Nbonds << endl;
@@ -809,13 +1052,13 @@ void Dump::dump_mol2()
   m_out << "@<TRIPOS>ATOM" << endl;
   for (int i = 0; i < N; i++)
   {
-    Particle& p = m_system->get_particle(i);
-    m_out << format("%d\t%d\t%10.6f\t%10.6f\t%10.6f\t%d") % (p.get_id()+1) % p.get_type() % p.x % p.y % p.z % p.get_type() << endl;
+    const DumpParticle& p = frame.particles[i];
+    m_out << format("%d\t%d\t%10.6f\t%10.6f\t%10.6f\t%d") % (p.id+1) % p.type % p.x % p.y % p.z % p.type << endl;
   }
   m_out << "@<TRIPOS>BOND" << endl;
   for (int i = 0; i < Nbonds; i++)
   {
-    Bond& b = m_system->get_bond(i);
+    const Bond& b = frame.bonds[i];
     m_out << format("%d\t%d\t%d\t%d") % (b.id + 1) % (b.i + 1) % (b.j + 1) % b.type << endl;
   }
 }
@@ -862,7 +1105,7 @@ void Dump::dump_contact()
     }
     bool periodic = m_system->get_periodic();
     int N = m_system->get_group(m_group)->get_size();
-    vector<int> particles = m_system->get_group(m_group)->get_particles();
+    const vector<int>& particles = m_system->get_group(m_group)->get_particles();
     int contact = 0;
     double rcut2 = rcut*rcut;
     for (int i = 0; i < N; i++)
@@ -891,24 +1134,18 @@ void Dump::dump_contact()
 //! Dump faces based on the contact network for particles
 //! Format is a simple text file with f+1 columns, where f in the number of vertices in a face
 //! Column 1: contact id (starting with 0)
-void Dump::dump_faces()
+//! \param frame staged frame
+void Dump::dump_faces(const DumpFrame& frame)
 {
-  if (!m_nlist)
-  {
-    m_msg->msg(Messenger::ERROR,"In order to produce faces based on the contact network you need to specify neighbour list. Please use nlist command.");
-    throw runtime_error("No neighbour list specified for faces dump.");
-  }
-  else if (m_nlist->has_faces())
+  if (frame.has_faces)
   {
-    Mesh& mesh = m_system->get_mesh();
     if (m_print_header)
        m_out << "#  face_id   partice_ids" << endl;
-    vector<Face>& faces = mesh.get_faces();
-    for (unsigned int i = 0; i < faces.size(); i++)
+    for (unsigned int i = 0; i < frame.face_ids.size(); i++)
     {
-      m_out << format("%d  ") % faces[i].id;
-      for (unsigned int j = 0; j < faces[i].vertices.size(); j++)
-        m_out << format("%d ") % faces[i].vertices[j];
+      m_out << format("%d  ") % frame.face_ids[i];
+      for (unsigned int j = 0; j < frame.face_vertices[i].size(); j++)
+        m_out << format("%d ") % frame.face_vertices[i][j];
       m_out << endl;
     }
   }
@@ -999,7 +1236,7 @@ void Dump::dump_vtp(int step)
   if (!m_output_dual)
   {
     int N = m_system->get_group(m_group)->get_size();
-    vector<int> particles = m_system->get_group(m_group)->get_particles();
+    const vector<int>& particles = m_system->get_group(m_group)->get_particles();
     
     vtkSmartPointer<vtkIntArray> ids =  vtkSmartPointer<vtkIntArray>::New();
     vtkSmartPointer<vtkIntArray> types =  vtkSmartPointer<vtkIntArray>::New();
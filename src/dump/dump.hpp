@@ -35,6 +35,7 @@
 #include <string>
 #include <map>
 #include <list>
+#include <deque>
 #include <boost/format.hpp>
 #include <boost/algorithm/string.hpp>
 
@@ -44,6 +45,9 @@
 #include <boost/iostreams/copy.hpp>
 #include <boost/iostreams/filter/gzip.hpp>
 
+// Background writer thread
+#include <boost/thread.hpp>
+
 // Handle VTP output
 #ifdef HAS_VTK
 #include <vtkVersion.h>
@@ -70,13 +74,68 @@ using std::ofstream;
 using std::map;
 using std::endl;
 using std::list;
+using std::deque;
 using boost::format;
 using boost::replace_all;
 
+/*! Per particle data copied out of the system when a frame is staged. 
+ *  Holds everything the staged dump formats (xyz, full, mol2 and face) can print.
+ */
+struct DumpParticle
+{
+  int id;                   //!< Particle id
+  int type;                 //!< Particle type
+  int flag;                 //!< Particle flag
+  int parent;               //!< Id of the parent particle
+  int molecule;             //!< Molecule id
+  int ix, iy, iz;           //!< Image flags
+  int cont_num;             //!< Number of contacts
+  double radius;            //!< Particle radius
+  double x, y, z;           //!< Position
+  double vx, vy, vz;        //!< Velocity
+  double fx, fy, fz;        //!< Force
+  double nx, ny, nz;        //!< Director
+  double Nx, Ny, Nz;        //!< Normal to the surface
+  double omega;             //!< Angular velocity
+  double A0;                //!< Native area
+  double area;              //!< Area of the dual cell
+  double perim;             //!< Perimeter of the dual cell
+  bool boundary;            //!< Particle is on the boundary
+  bool in_tissue;           //!< Particle belongs to the tissue
+};
+
+/*! Snapshot of all data needed to write one dump frame. It is taken 
+ *  on the simulation thread at a step boundary, so that formatting, 
+ *  compression and file output can happen later (possibly in a different thread).
+ */
+struct DumpFrame
+{
+  int step;                              //!< Time step of the frame
+  string file_name;                      //!< Output file (only for dumps into multiple files)
+  double Lx, Ly, Lz;                     //!< Box size (for unwrapping coordinates)
+  bool has_faces;                        //!< Neighbour list has built faces (dual cell areas and perimeters are valid)
+  bool has_contacts;                     //!< Neighbour list has contacts (contact numbers are valid)
+  vector<DumpParticle> particles;        //!< Particles to print
+  vector<Bond> bonds;                    //!< Bonds (MOL2 only)
+  vector<int> face_ids;                  //!< Face ids (face dump only)
+  vector<vector<int> > face_vertices;    //!< Vertices of each face (face dump only)
+};
+
+typedef shared_ptr<DumpFrame> DumpFramePtr;
+
 /*! Dump class handles output of system's state, such 
  *  as particle coordinates, velocities, forces, etc.
  *  It supports number of formats that can be used for
  *  subsequent data analysis and visualization.
+ *  
+ *  Formats xyz, full, mol2 and face are written in two stages. At the 
+ *  step boundary, the data is copied into a DumpFrame. The frame is then 
+ *  formatted and written either immediately or, if the dump has the async flag,
+ *  by a background writer thread. At most queue_depth frames (default 2) are 
+ *  in flight; if the writer falls behind the simulation waits for it (back-pressure). 
+ *  Time spent waiting is reported at the end of each run.
+ *  \note Writer thread does not send any messages (Messenger is not thread safe). 
+ *  Write errors are reported by the main thread at the end of the run.
  */
 class Dump
 {
@@ -85,16 +144,14 @@ public:
   Dump(SystemPtr, MessengerPtr, NeighbourListPtr, const string&, pairs_type&);
   
   //! Destructor
-  ~Dump()
-  {
-    if (!m_multi_print) m_file.close();
-    m_type_ext.clear();
-    m_to_print.clear();
-  }
+  ~Dump();
   
   //! Do actual dump 
   void dump(int);
   
+  //! Wait for all frames to be written and report the time lost waiting for the writer
+  void finish();
+  
 private:
   
   SystemPtr m_system;           //!< Pointer to the System object
@@ -121,6 +178,19 @@ private:
   bool m_include_mesh;          //!< If true, output mesh  
   string m_group;               //!< Dump this group
   string m_directory;           //!< Directory in which to redirect output
+  bool m_async;                 //!< If true, staged frames are written by a background thread
+  int m_queue_depth;            //!< Maximum number of frames waiting to be written (or being written)
+  
+  // Background writer
+  boost::thread m_writer;                 //!< Writer thread
+  boost::mutex m_queue_mutex;             //!< Protects the queue, the stop flag, the counters and the error message
+  boost::condition_variable m_not_empty;  //!< Signals that a frame has been queued (or that the writer should stop)
+  boost::condition_variable m_not_full;   //!< Signals that a frame has been written
+  deque<DumpFramePtr> m_queue;            //!< Frames waiting to be written (front one is being written)
+  bool m_stop;                            //!< Tells the writer thread to exit once the queue is empty
+  int m_frames;                           //!< Number of frames written in the background since the last report
+  double m_stall_time;                    //!< Time (in seconds) the simulation waited for the writer since the last report
+  string m_error;                         //!< First write error since the last report (empty if none)
   
   // Auxiliary data structures
   map<string, string> m_type_ext;  //!< Hold extension for a given data type
@@ -129,12 +199,22 @@ private:
   
   // private member methods that do actual dumping
   // these methods cannot be called directly 
+  //! Check if the dump type is written through staged frames
+  bool staged() { return (m_type == "xyz" || m_type == "full" || m_type == "mol2" || m_type == "face"); }
+  //! Copy data needed for the current dump type into a frame
+  void stage(DumpFrame&);
+  //! Format frame and write it to the output file
+  void write_frame(const DumpFrame&);
+  //! Hand frame over to the writer thread (waits while the queue is full)
+  void submit(DumpFramePtr);
+  //! Main loop of the writer thread
+  void write_loop();
   //! DCD dump
   void dump_dcd();         
   //! XYZ dump (XYZ file format)
-  void dump_xyz();
+  void dump_xyz(const DumpFrame&);
   //! Dump a selected list of parameters
-  void dump_data();
+  void dump_data(const DumpFrame&);
   //! Dump input format for restarts
   void dump_input();
   //! Dump velocities
@@ -146,11 +226,11 @@ private:
   //! Dump XYZC file format for visualization with SimRePlay
   void dump_xyzc();
   //! Dump MOL2 file format for visualization with VMD
-  void dump_mol2();
+  void dump_mol2(const DumpFrame&);
   //! Dump contact network for further analysis
   void dump_contact();
   //! Dump faces based on the contact network
-  void dump_faces();
+  void dump_faces(const DumpFrame&);
   //! Dump mesh (for tissues)
   void dump_mesh();
   //! Dump boundary (for restarting tissue simulations)
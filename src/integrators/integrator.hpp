@@ -70,7 +70,9 @@ public:
                                                                                                                                                                    m_align(align),
                                                                                                                                                                    m_nlist(nlist),
                                                                                                                                                                    m_constrainer(cons),
-                                                                                                                                                                   m_temp(temp)
+                                                                                                                                                                   m_temp(temp),
+                                                                                                                                                                   m_adaptive(false),
+                                                                                                                                                                   m_run_time(0.0)
   { 
     m_known_params.push_back("dt");
     m_known_params.push_back("group");
@@ -86,7 +88,7 @@ public:
     }
     else
     {
-      m_dt = m_system->get_integrator_step();
+      m_dt = m_system->get_nominal_step();
       m_msg->msg(Messenger::INFO,"Using global (system-wide) integrator step size set to "+lexical_cast<string>(m_dt)+".");
     }
     if (m_dt <= 0.0)
@@ -95,6 +97,7 @@ public:
       throw runtime_error("Integrator step has not been set.");
     }
     m_msg->write_config("integrator.dt",lexical_cast<string>(m_dt));
+    m_dt_ref = m_dt;
     if (param.find("group") == param.end())
     {
       m_msg->msg(Messenger::WARNING,"No group has been set. Assuming group 'all'.");
@@ -113,6 +116,17 @@ public:
   //! Propagate system for a time step
   virtual void integrate() = 0;
   
+  //! Returns true if integrator has reached its goal and the run can be stopped (e.g., minimisation converged)
+  //! \note By default, integrators never converge
+  virtual bool converged() { return false; }
+  
+  //! Save integrator state that is not set by the input script (e.g., random number generator)
+  //! \note By default, integrators have no such state
+  virtual void write_checkpoint(CheckpointWriter&) { }
+  
+  //! Restore integrator state saved with write_checkpoint
+  virtual void read_checkpoint(CheckpointReader&) { }
+  
   //! Check if there are no illegal parameters
   string params_ok(pairs_type& params)
   {
@@ -124,6 +138,119 @@ public:
 
 protected:
   
+  //! Add parameters controlling adaptive time step to the list of known parameters
+  //! \note Has to be called before params_ok by integrators that support adaptive time step
+  void add_adaptive_params()
+  {
+    m_known_params.push_back("max_disp");
+    m_known_params.push_back("dt_min");
+    m_known_params.push_back("dt_max");
+    m_known_params.push_back("dt_grow");
+  }
+  
+  //! Read parameters controlling adaptive time step
+  //! \param param Contains information about all parameters 
+  //! \param name Name of the integrator (used in messages and config output)
+  void read_adaptive_params(pairs_type& param, const string& name)
+  {
+    if (param.find("max_disp") == param.end())
+    {
+      m_adaptive = false;
+      return;
+    }
+    m_adaptive = true;
+    m_max_disp = lexical_cast<double>(param["max_disp"]);
+    m_msg->msg(Messenger::INFO,name+" integrator. Using adaptive time step. Maximum displacement per step set to "+param["max_disp"]+" particle radii.");
+    m_msg->write_config("integrator."+name+".max_disp",lexical_cast<string>(m_max_disp));
+    if (param.find("dt_min") == param.end())
+    {
+      m_msg->msg(Messenger::WARNING,name+" integrator. Minimum time step not set. Using default value 0.001*dt.");
+      m_dt_min = 0.001*m_dt_ref;
+    }
+    else
+    {
+      m_msg->msg(Messenger::INFO,name+" integrator. Setting minimum time step to "+param["dt_min"]+".");
+      m_dt_min = lexical_cast<double>(param["dt_min"]);
+    }
+    m_msg->write_config("integrator."+name+".dt_min",lexical_cast<string>(m_dt_min));
+    if (param.find("dt_max") == param.end())
+    {
+      m_msg->msg(Messenger::WARNING,name+" integrator. Maximum time step not set. Using dt.");
+      m_dt_max = m_dt_ref;
+    }
+    else
+    {
+      m_msg->msg(Messenger::INFO,name+" integrator. Setting maximum time step to "+param["dt_max"]+".");
+      m_dt_max = lexical_cast<double>(param["dt_max"]);
+    }
+    m_msg->write_config("integrator."+name+".dt_max",lexical_cast<string>(m_dt_max));
+    if (param.find("dt_grow") == param.end())
+    {
+      m_msg->msg(Messenger::WARNING,name+" integrator. Time step growth factor not set. Using default value 1.1.");
+      m_dt_grow = 1.1;
+    }
+    else
+    {
+      m_msg->msg(Messenger::INFO,name+" integrator. Setting time step growth factor to "+param["dt_grow"]+".");
+      m_dt_grow = lexical_cast<double>(param["dt_grow"]);
+    }
+    m_msg->write_config("integrator."+name+".dt_grow",lexical_cast<string>(m_dt_grow));
+    if (m_max_disp <= 0.0 || m_dt_min <= 0.0 || m_dt_min > m_dt_max || m_dt_grow < 1.0)
+    {
+      m_msg->msg(Messenger::ERROR,name+" integrator. Adaptive time step requires max_disp > 0, 0 < dt_min <= dt_max and dt_grow >= 1.");
+      throw runtime_error("Invalid adaptive time step parameters in "+name+" integrator.");
+    }
+  }
+  
+  //! Largest displacement a particle is allowed to make in a single step
+  //! It is a fraction max_disp of the particle radius, but never more than half of the 
+  //! neighbour list padding (otherwise a particle could cross the skin in a single step). 
+  //! \param p particle
+  double max_allowed_disp(Particle& p)
+  {
+    double d = m_max_disp*p.get_radius();
+    if (m_nlist && 0.5*m_nlist->get_pad() < d)
+      d = 0.5*m_nlist->get_pad();
+    return d;
+  }
+  
+  //! Largest ratio of displacement to its allowed value (max_allowed_disp) over all particles 
+  //! if a step of size dt were made in the current configuration
+  //! \note Integrators that support adaptive time step have to override this
+  virtual double max_disp_ratio(double) { return 0.0; }
+  
+  //! Choose the size of the next time step
+  //! The step is grown by dt_grow (up to dt_max) and then shrunk until no particle
+  //! moves more than allowed or it reaches dt_min. 
+  //! \return size of the next time step
+  double adapt_step()
+  {
+    double dt = m_dt*m_dt_grow;
+    if (dt > m_dt_max) dt = m_dt_max;
+    double ratio = this->max_disp_ratio(dt);
+    for (int iter = 0; ratio > 1.0 && dt > m_dt_min && iter < 20; iter++)
+    {
+      dt *= 0.9/ratio;
+      if (dt < m_dt_min) dt = m_dt_min;
+      ratio = this->max_disp_ratio(dt);
+    }
+    return dt;
+  }
+  
+  //! Step used to look up schedules (e.g., temperature) that are given in terms of steps of the current run
+  //! With adaptive time step, this is the time elapsed since the beginning of the run measured in units of the nominal time step
+  int schedule_step()
+  {
+    if (!m_adaptive)
+      return m_system->get_run_step();
+    if (m_system->get_run_step() == 0)
+      m_run_time = 0.0;
+    return static_cast<int>(m_run_time/m_dt_ref + 0.5);
+  }
+  
+  //! Add the step that has just been made to the time elapsed since the beginning of the run
+  void advance_run_time() { m_run_time += m_dt; }
+  
   SystemPtr m_system;            //!< Pointer to the System object
   MessengerPtr m_msg;            //!< Pointer to the messenger object
   PotentialPtr m_potential;      //!< Pointer to the interaction handler 
@@ -132,6 +259,13 @@ protected:
   ConstrainerPtr m_constrainer;  //!< Pointer to the handler for constraints
   ValuePtr m_temp;               //!< Pointer to the handler of current value of temperature 
   double m_dt;                   //!< time step
+  double m_dt_ref;               //!< time step set in the input file (with adaptive time step, m_dt may differ from it)
+  bool   m_adaptive;             //!< If true, adjust time step to limit particle displacement per step
+  double m_max_disp;             //!< Maximum displacement per step (in units of particle radius)
+  double m_dt_min;               //!< Smallest allowed time step 
+  double m_dt_max;               //!< Largest allowed time step 
+  double m_dt_grow;              //!< Factor by which time step is allowed to grow in a single step
+  double m_run_time;             //!< Time elapsed since the beginning of the current run (sum of actual step sizes)
   string m_group_name;           //!< Name of the group to apply this integrator to
   vector<string> m_known_params; //!< Lists all known parameters accepted by a given integrator
 
@@ -105,9 +105,10 @@ void IntegratorActomyo::integrate()
     p.vy = p.fy/m_zeta; 
     p.vz = p.fz/m_zeta; 
     // Update particle position 
-    p.x += m_dt*p.vx + m_stoch_coeff*m_rng->gauss_rng(1.0);
-    p.y += m_dt*p.vy + m_stoch_coeff*m_rng->gauss_rng(1.0);
-    p.z += m_dt*p.vz + m_stoch_coeff*m_rng->gauss_rng(1.0);
+    double dx = m_dt*p.vx + m_stoch_coeff*m_rng->gauss_rng(1.0);
+    double dy = m_dt*p.vy + m_stoch_coeff*m_rng->gauss_rng(1.0);
+    double dz = m_dt*p.vz + m_stoch_coeff*m_rng->gauss_rng(1.0);
+    p.move(dx, dy, dz);
     // Project everything back to the manifold
     m_constrainer->enforce(p);
     p.age += m_dt;
@@ -81,13 +81,13 @@ public:
     if (param.find("seed") == param.end())
     {
       m_msg->msg(Messenger::WARNING,"Actomyo dynamics integrator. No random number generator seed specified. Using default 0.");
-      m_rng = make_shared<RNG>(0);
+      m_rng = make_shared<RNG>(0,"integrator_actomyo");
       m_msg->write_config("integrator.actomyo.seed",lexical_cast<string>(0));
     }
     else
     {
       m_msg->msg(Messenger::INFO,"Actomyo dynamics integrator. Setting random number generator seed to "+param["seed"]+".");
-      m_rng = make_shared<RNG>(lexical_cast<int>(param["seed"]));
+      m_rng = make_shared<RNG>(lexical_cast<int>(param["seed"]),"integrator_actomyo");
       m_msg->write_config("integrator.actomyo.seed",param["seed"]);
     }
     if (param.find("f") == param.end())
@@ -42,76 +42,104 @@
 void IntegratorBrownian::integrate()
 {
   int N = m_system->get_group(m_group_name)->get_size();
-  double T = m_temp->get_val(m_system->get_run_step());
+  double T = m_temp->get_val(this->schedule_step());
   double B = sqrt(2.0*m_mu*T);
-  double sqrt_dt = sqrt(m_dt);
-  double fd_x, fd_y, fd_z;                    // Deterministic part of the force
-  double fr_x = 0.0, fr_y = 0.0, fr_z = 0.0;  // Random part of the force
-  vector<int> particles = m_system->get_group(m_group_name)->get_particles();
+  int step = m_system->get_step();
+  const vector<int>& particles = m_system->get_group(m_group_name)->get_particles();
   
   // reset forces and torques
   m_system->reset_forces();
   m_system->reset_torques();
   
-  // If nematic, attempt to flip directors
+  // compute forces in the current configuration (phase-in is always measured in units of the nominal time step)
+  if (m_potential)
+    m_potential->compute(m_dt_ref);
+  // generate noise for all particles in one batch (three translational and one rotational number per particle)
+  if (T > 0.0 || m_stoch_coeff > 0.0)
+  {
+    m_flags.resize(N);
+    for (int i = 0; i < N; i++)
+      m_flags[i] = m_system->get_particle(particles[i]).get_flag();
+    m_rng->gauss_rng(1.0, m_flags, step, 1, m_noise);
+  }
+  else
+    m_noise.assign(4*N, 0.0);
+  // choose time step such that no particle moves too far 
+  if (m_adaptive)
+    this->set_step(this->adapt_step());
+  // If nematic, attempt to flip directors (after the step has been chosen, so that the flip probability matches it)
   if (m_nematic)
+  {
+    int flipped = 0;
+    #pragma omp parallel for reduction(+:flipped)
     for (int i = 0; i < N; i++)
     {
       int pi = particles[i];
       Particle& p = m_system->get_particle(pi);
-      if (m_rng->drnd() < m_tau)  // Flip direction n with probability m_tua (dt/tau, where tau is the parameter given in the input file).
+      if (m_rng->drnd(p.get_flag(), step, 0) < m_tau)  // Flip direction n with probability m_tua (dt/tau, where tau is the parameter given in the input file).
       {
         p.nx = -p.nx;  p.ny = -p.ny;  p.nz = -p.nz;
         if (m_velocity)
         {
           p.vx = -p.vx;  p.vy = -p.vy;  p.vz = -p.vz;
         }
+        flipped++;
       }
     }
-  
-  // compute forces in the current configuration
-  if (m_potential)
-    m_potential->compute(m_dt);
+    // forces may depend on directors, so recompute them if any of the directors has been flipped
+    if (flipped > 0 && m_potential)
+    {
+      m_system->reset_forces();
+      m_potential->compute(m_dt_ref);
+    }
+  }
   // compute torques in the current configuration
   if (m_align)
     m_align->compute();
-  // iterate over all particles 
+  double sqrt_dt = sqrt(m_dt);
+  // iterate over all particles (particles are independent, so the loop can run in parallel)
+  #pragma omp parallel for
   for (int i = 0; i < N; i++)
   {
     int pi = particles[i];
     Particle& p = m_system->get_particle(pi);
+    const double* g = &m_noise[4*i];
     // compute deterministic forces
-    fd_x = m_v0*p.nx + m_mu*p.fx; 
-    fd_y = m_v0*p.ny + m_mu*p.fy;
-    fd_z = m_v0*p.nz + m_mu*p.fz;
+    double fd_x = m_v0*p.nx + m_mu*p.fx; 
+    double fd_y = m_v0*p.ny + m_mu*p.fy;
+    double fd_z = m_v0*p.nz + m_mu*p.fz;
     // Update velocity
     p.vx = fd_x; 
     p.vy = fd_y;
     p.vz = fd_z;
     // Update particle position according to the eq. (1a)
-    p.x += m_dt*fd_x;
-    p.y += m_dt*fd_y;
-    p.z += m_dt*fd_z;
+    p.move(m_dt*fd_x, m_dt*fd_y, m_dt*fd_z);
     // Check is non-zero T
     if (T > 0.0)
     {
-      fr_x = B*m_rng->gauss_rng(1.0);
-      fr_y = B*m_rng->gauss_rng(1.0);
-      fr_z = B*m_rng->gauss_rng(1.0);
+      double fr_x = B*g[0];
+      double fr_y = B*g[1];
+      double fr_z = B*g[2];
       p.vx += fr_x; 
       p.vy += fr_y;
       p.vz += fr_z;  
-      p.x += sqrt_dt*fr_x;
-      p.y += sqrt_dt*fr_y;
-      p.z += sqrt_dt*fr_z;
+      p.move(sqrt_dt*fr_x, sqrt_dt*fr_y, sqrt_dt*fr_z);
     }
-    // Project everything back to the manifold
-    m_constrainer->enforce(p);
+  }
+  // Project everything back to the manifold (once for the entire group)
+  m_constrainer->enforce(particles);
+  // Update orientations
+  #pragma omp parallel for
+  for (int i = 0; i < N; i++)
+  {
+    int pi = particles[i];
+    Particle& p = m_system->get_particle(pi);
+    const double* g = &m_noise[4*i];
     // Update angular velocity
     p.omega = m_mur*m_constrainer->project_torque(p);
     //p.omega = m_dt*m_constraint->project_torque(p);
     // Change orientation of the director (in the tangent plane) according to eq. (1b)
-    double dtheta = m_dt*p.omega + m_stoch_coeff*m_rng->gauss_rng(1.0);
+    double dtheta = m_dt*p.omega + m_stoch_coeff*g[3];
     //double dtheta = m_dt*m_constraint->project_torque(p) + m_stoch_coeff*m_rng->gauss_rng(1.0);
     m_constrainer->rotate_director(p,dtheta);
     if (m_velocity)
@@ -119,6 +147,39 @@ void IntegratorBrownian::integrate()
     //p.omega = dtheta*m_dt;
     p.age += m_dt;
   }
+  this->advance_run_time();
   // Update vertex mesh
   m_system->update_mesh();
 }
+
+/*! Displacement of each particle is computed exactly as it would be in integrate(), 
+ *  using the forces and noise of the current step. Constraints are not enforced
+ *  (projecting back to the surface typically shortens the step).
+ *  \param dt trial time step
+**/
+double IntegratorBrownian::max_disp_ratio(double dt)
+{
+  int N = m_system->get_group(m_group_name)->get_size();
+  double T = m_temp->get_val(this->schedule_step());
+  double B = (T > 0.0) ? sqrt(2.0*m_mu*T*dt) : 0.0;
+  const vector<int>& particles = m_system->get_group(m_group_name)->get_particles();
+  double ratio = 0.0;
+  for (int i = 0; i < N; i++)
+  {
+    Particle& p = m_system->get_particle(particles[i]);
+    const double* g = &m_noise[4*i];
+    double dx = dt*(m_v0*p.nx + m_mu*p.fx) + B*g[0];
+    double dy = dt*(m_v0*p.ny + m_mu*p.fy) + B*g[1];
+    double dz = dt*(m_v0*p.nz + m_mu*p.fz) + B*g[2];
+    double r = sqrt(dx*dx + dy*dy + dz*dz)/this->max_allowed_disp(p);
+    if (r > ratio) ratio = r;
+    // in nematic systems director may be flipped after the step has been chosen, so check the other orientation, too
+    if (m_nematic)
+    {
+      dx -= 2.0*dt*m_v0*p.nx;  dy -= 2.0*dt*m_v0*p.ny;  dz -= 2.0*dt*m_v0*p.nz;
+      r = sqrt(dx*dx + dy*dy + dz*dz)/this->max_allowed_disp(p);
+      if (r > ratio) ratio = r;
+    }
+  }
+  return ratio;
+}
@@ -62,6 +62,7 @@ public:
     m_known_params.push_back("nematic");
     m_known_params.push_back("tau");
     m_known_params.push_back("velocity_align");
+    this->add_adaptive_params();
     string param_test = this->params_ok(param);
     if (param_test != "")
     {
@@ -116,13 +117,13 @@ public:
     if (param.find("seed") == param.end())
     {
       m_msg->msg(Messenger::WARNING,"Brownian dynamics integrator. No random number generator seed specified. Using default 0.");
-      m_rng = make_shared<RNG>(0);
+      m_rng = make_shared<RNG>(0,"integrator_brownian");
       m_msg->write_config("integrator.brownian.seed",lexical_cast<string>(0));
     }
     else
     {
       m_msg->msg(Messenger::INFO,"Brownian dynamics integrator. Setting random number generator seed to "+param["seed"]+".");
-      m_rng = make_shared<RNG>(lexical_cast<int>(param["seed"]));
+      m_rng = make_shared<RNG>(lexical_cast<int>(param["seed"]),"integrator_brownian");
       m_msg->write_config("integrator.brownian.seed",param["seed"]);
     }
     if (param.find("nematic") == param.end())
@@ -157,12 +158,32 @@ public:
       m_velocity = true;
     }
     m_stoch_coeff = sqrt(m_nu*m_dt);
+    this->read_adaptive_params(param,"brownian");
   }
   
   
   //! Propagate system for a time step
   void integrate();
   
+  //! Save current time step (if it is adaptive)
+  //! \param ckp checkpoint writer
+  void write_checkpoint(CheckpointWriter& ckp)
+  {
+    if (m_adaptive) ckp.write(m_dt);
+  }
+  
+  //! Restore current time step (if it is adaptive)
+  //! \param ckp checkpoint reader
+  void read_checkpoint(CheckpointReader& ckp)
+  {
+    if (m_adaptive) 
+    {
+      double dt;
+      ckp.read(dt);
+      this->set_step(dt);
+    }
+  }
+  
 private:
   
   RNGPtr  m_rng;          //!< Random number generator 
@@ -174,6 +195,20 @@ private:
   bool    m_nematic;      //!< If true; assume that the system is nematic, and the velocity will switch direction randomly
   double  m_tau;          //!< Time scale for the direction flip for nematic systems (flip with probability dt/tau)
   bool    m_velocity;     //!< If true, apply torque to velocity (this is used in simulations with velocity alignmant)
+  vector<int>    m_flags; //!< Flags of all particles in the group (keys for the random streams)
+  vector<double> m_noise; //!< Gaussian noise for the current step (four numbers per particle)
+  
+  //! Largest ratio of displacement to its allowed value for a step of size dt (uses current forces and noise)
+  double max_disp_ratio(double);
+  
+  //! Change time step and update all coefficients that depend on it
+  void set_step(double dt)
+  {
+    if (m_nematic) m_tau *= dt/m_dt;  // flip probability is dt/tau
+    m_dt = dt;
+    m_stoch_coeff = sqrt(m_nu*m_dt);
+    m_system->set_current_step(m_dt);  // populations use the step actually made
+  }
   
 };
 
@@ -41,27 +41,32 @@
 void IntegratorBrownianAlign::integrate()
 {
   int N = m_system->get_group(m_group_name)->get_size();
-  vector<int> particles = m_system->get_group(m_group_name)->get_particles();
+  int step = m_system->get_step();
+  const vector<int>& particles = m_system->get_group(m_group_name)->get_particles();
   
   // reset torques
   m_system->reset_torques();
   
   // If nematic, attempt to flip directors
   if (m_nematic)
+  {
+    #pragma omp parallel for
     for (int i = 0; i < N; i++)
     {
       int pi = particles[i];
       Particle& p = m_system->get_particle(pi);
-      if (m_rng->drnd() < m_tau)  // Flip direction n with probability m_tua (dt/tau, where tau is the parameter given in the input file).
+      if (m_rng->drnd(p.get_flag(), step, 0) < m_tau)  // Flip direction n with probability m_tua (dt/tau, where tau is the parameter given in the input file).
       {
         p.nx = -p.nx;  p.ny = -p.ny;  p.nz = -p.nz;
       }
     }
+  }
   
   // compute torques in the current configuration
   if (m_align)
     m_align->compute();
-  // iterate over all particles 
+  // iterate over all particles (particles are independent, so the loop can run in parallel)
+  #pragma omp parallel for
   for (int i = 0; i < N; i++)
   {
     int pi = particles[i];
@@ -69,7 +74,7 @@ void IntegratorBrownianAlign::integrate()
     // Update angular velocity
     p.omega = m_mur*m_constrainer->project_torque(p);
     // Change orientation of the director (in the tangent plane) according to eq. (1b)
-    double dtheta = m_dt*p.omega + m_stoch_coeff*m_rng->gauss_rng(1.0);
+    double dtheta = m_dt*p.omega + m_stoch_coeff*m_rng->gauss_rng(1.0, p.get_flag(), step, 1);
     //double dtheta = m_dt*m_constraint->project_torque(p) + m_stoch_coeff*m_rng->gauss_rng(1.0);
     m_constrainer->rotate_director(p,dtheta);
   }
@@ -90,13 +90,13 @@ public:
     if (param.find("seed") == param.end())
     {
       m_msg->msg(Messenger::WARNING,"Brownian dynamics integrator for alignment. No random number generator seed specified. Using default 0.");
-      m_rng = make_shared<RNG>(0);
+      m_rng = make_shared<RNG>(0,"integrator_brownian_align");
       m_msg->write_config("integrator.brownian_align.seed",lexical_cast<string>(0));
     }
     else
     {
       m_msg->msg(Messenger::INFO,"Brownian dynamics integrator for alignment. Setting random number generator seed to "+param["seed"]+".");
-      m_rng = make_shared<RNG>(lexical_cast<int>(param["seed"]));
+      m_rng = make_shared<RNG>(lexical_cast<int>(param["seed"]),"integrator_brownian_align");
       m_msg->write_config("integrator.brownian_align.seed",param["seed"]);
     }
     if (param.find("nematic") == param.end())
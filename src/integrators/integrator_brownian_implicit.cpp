@@ -0,0 +1,250 @@
+/* ***************************************************************************
+ *
+ *  Copyright (C) 2013-2016 University of Dundee
+ *  All rights reserved. 
+ *
+ *  This file is part of SAMoS (Soft Active Matter on Surfaces) program.
+ *
+ *  SAMoS is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  SAMoS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ****************************************************************************/
+
+/*!
+ * \file integrator_brownian_implicit.cpp
+ * \author Rastko Sknepnek, sknepnek@gmail.com
+ * \date 18-Oct-2026
+ * \brief Implementation of the implicit Brownian dynamics integrator for particle position.
+ */ 
+
+#include "integrator_brownian_implicit.hpp"
+
+/*! Integrates equation of motion in the over-damped limit using the backward Euler scheme. 
+ *  Residual of the scheme is \f$ \vec R = \vec r - \vec r^n - \delta t v_0\hat{\vec n}^n - \delta t\mu\vec F\left(\vec r\right) - \vec\xi \f$, 
+ *  where \f$ \vec\xi \f$ is the random displacement. Starting from the explicit Euler 
+ *  prediction, Newton iterations are carried out until the largest component of the 
+ *  residual drops below the tolerance. Director is then updated explicitly, using torques 
+ *  computed at the beginning of the step, as in IntegratorBrownian.
+ *  \note Forces in the system after the step are those at the final Newton iterate.
+**/
+void IntegratorBrownianImplicit::integrate()
+{
+  int N = m_system->get_group(m_group_name)->get_size();
+  int n = 3*N;
+  double T = m_temp->get_val(m_system->get_run_step());
+  double B = sqrt(2.0*m_mu*T*m_dt);
+  double dt_mu = m_dt*m_mu;
+  int step = m_system->get_step();
+  const vector<int>& particles = m_system->get_group(m_group_name)->get_particles();
+  
+  // compute torques in the current configuration (director update is explicit)
+  m_system->reset_torques();
+  if (m_align)
+    m_align->compute();
+  
+  m_x0.resize(n);  m_a.resize(n);  m_x.resize(n);  m_xi.resize(n);  m_f.resize(n);  m_r.resize(n);
+  m_dx.resize(n);  m_p.resize(n);  m_Ap.resize(n);  m_xp.resize(n);  m_fp.resize(n);
+  
+  for (int i = 0; i < N; i++)
+  {
+    Particle& p = m_system->get_particle(particles[i]);
+    p.get_position(m_x0[3*i], m_x0[3*i+1], m_x0[3*i+2]);
+    m_a[3*i] = m_dt*m_v0*p.nx;  m_a[3*i+1] = m_dt*m_v0*p.ny;  m_a[3*i+2] = m_dt*m_v0*p.nz;
+  }
+  
+  // generate noise for all particles in one batch (three translational and one rotational number per particle)
+  if (T > 0.0 || m_stoch_coeff > 0.0)
+  {
+    m_flags.resize(N);
+    for (int i = 0; i < N; i++)
+      m_flags[i] = m_system->get_particle(particles[i]).get_flag();
+    m_rng->gauss_rng(1.0, m_flags, step, 1, m_noise);
+  }
+  else
+    m_noise.assign(4*N, 0.0);
+  for (int i = 0; i < N; i++)
+  {
+    m_xi[3*i] = B*m_noise[4*i];  m_xi[3*i+1] = B*m_noise[4*i+1];  m_xi[3*i+2] = B*m_noise[4*i+2];
+  }
+  
+  // Explicit Euler prediction 
+  this->compute_forces(m_x0, m_f);
+  for (int k = 0; k < n; k++)
+    m_x[k] = m_x0[k] + m_a[k] + dt_mu*m_f[k] + m_xi[k];
+  
+  // Newton iterations
+  bool converged = false;
+  for (int iter = 0; iter < m_newton_iter; iter++)
+  {
+    this->compute_forces(m_x, m_f);
+    double res = 0.0;
+    for (int k = 0; k < n; k++)
+    {
+      m_r[k] = m_x[k] - m_x0[k] - m_a[k] - dt_mu*m_f[k] - m_xi[k];
+      if (fabs(m_r[k]) > res) res = fabs(m_r[k]);
+    }
+    if (res < m_tol)
+    {
+      converged = true;
+      break;
+    }
+    this->solve();
+    for (int k = 0; k < n; k++)
+      m_x[k] += m_dx[k];
+  }
+  if (!converged)
+  {
+    // Last force evaluation was at a perturbed (or previous) iterate, so recompute forces for the final positions
+    this->compute_forces(m_x, m_f);
+    if (!m_warned)
+    {
+      m_msg->msg(Messenger::WARNING,"Implicit Brownian dynamics integrator. Newton iterations did not converge at step "+lexical_cast<string>(step)+". Consider increasing newton_iter or reducing time step. This warning is issued only once.");
+      m_warned = true;
+    }
+  }
+  
+  // Update particles
+  #pragma omp parallel for
+  for (int i = 0; i < N; i++)
+  {
+    Particle& p = m_system->get_particle(particles[i]);
+    p.set_position(m_x[3*i], m_x[3*i+1], m_x[3*i+2]);
+    p.vx = (m_x[3*i] - m_x0[3*i])/m_dt;
+    p.vy = (m_x[3*i+1] - m_x0[3*i+1])/m_dt;
+    p.vz = (m_x[3*i+2] - m_x0[3*i+2])/m_dt;
+    p.fx = m_f[3*i];  p.fy = m_f[3*i+1];  p.fz = m_f[3*i+2];
+  }
+  // Project everything back to the manifold (once for the entire group)
+  m_constrainer->enforce(particles);
+  // Update orientations
+  #pragma omp parallel for
+  for (int i = 0; i < N; i++)
+  {
+    Particle& p = m_system->get_particle(particles[i]);
+    p.omega = m_mur*m_constrainer->project_torque(p);
+    double dtheta = m_dt*p.omega + m_stoch_coeff*m_noise[4*i+3];
+    m_constrainer->rotate_director(p,dtheta);
+    p.age += m_dt;
+  }
+  // Update vertex mesh
+  m_system->update_mesh();
+}
+
+/*! Set positions of all particles in the group, update the mesh (for tissues)
+ *  and compute forces. 
+ *  \param x positions (three per particle)
+ *  \param f computed forces (three per particle)
+**/
+void IntegratorBrownianImplicit::compute_forces(const vector<double>& x, vector<double>& f)
+{
+  int N = m_system->get_group(m_group_name)->get_size();
+  const vector<int>& particles = m_system->get_group(m_group_name)->get_particles();
+  #pragma omp parallel for
+  for (int i = 0; i < N; i++)
+  {
+    Particle& p = m_system->get_particle(particles[i]);
+    p.set_position(x[3*i], x[3*i+1], x[3*i+2]);
+  }
+  m_system->update_mesh();
+  m_system->reset_forces();
+  if (m_potential)
+    m_potential->compute(m_dt);
+  #pragma omp parallel for
+  for (int i = 0; i < N; i++)
+  {
+    Particle& p = m_system->get_particle(particles[i]);
+    f[3*i] = p.fx;  f[3*i+1] = p.fy;  f[3*i+2] = p.fz;
+  }
+}
+
+/*! Apply the Newton matrix \f$ A = I - \delta t\mu J \f$ to a vector v. 
+ *  Product \f$ Jv \f$ is approximated by the forward difference 
+ *  \f$ \left(\vec F\left(\vec r + \epsilon v\right) - \vec F\left(\vec r\right)\right)/\epsilon \f$, 
+ *  where \f$ \vec r \f$ is the current Newton iterate with forces already stored in m_f. 
+ *  \param v vector 
+ *  \param Av result
+**/
+void IntegratorBrownianImplicit::apply(const vector<double>& v, vector<double>& Av)
+{
+  int n = v.size();
+  double dt_mu = m_dt*m_mu;
+  double vnorm = 0.0, xnorm = 0.0;
+  for (int k = 0; k < n; k++)
+  {
+    vnorm += v[k]*v[k];
+    xnorm += m_x[k]*m_x[k];
+  }
+  vnorm = sqrt(vnorm);
+  if (vnorm == 0.0)
+  {
+    Av.assign(n, 0.0);
+    return;
+  }
+  double eps = 1e-8*(1.0 + sqrt(xnorm/n))/(vnorm/sqrt(static_cast<double>(n)));
+  for (int k = 0; k < n; k++)
+    m_xp[k] = m_x[k] + eps*v[k];
+  this->compute_forces(m_xp, m_fp);
+  for (int k = 0; k < n; k++)
+    Av[k] = v[k] - dt_mu*(m_fp[k] - m_f[k])/eps;
+}
+
+/*! Solve \f$ A\,\delta\vec r = -\vec R \f$ with conjugate gradients. For conservative forces 
+ *  A is symmetric. Should a direction of non-positive curvature be encountered (unstable 
+ *  configurations), iterations stop and the update obtained so far is used (or the residual 
+ *  direction if no update has been accumulated). 
+ *  \return number of iterations
+**/
+int IntegratorBrownianImplicit::solve()
+{
+  int n = m_r.size();
+  // Start from zero, so that the CG residual is -R
+  double rr = 0.0;
+  for (int k = 0; k < n; k++)
+  {
+    m_dx[k] = 0.0;
+    m_r[k] = -m_r[k];
+    m_p[k] = m_r[k];
+    rr += m_r[k]*m_r[k];
+  }
+  double rr0 = rr;
+  int iter;
+  for (iter = 0; iter < m_lin_iter; iter++)
+  {
+    if (rr <= m_lin_tol*m_lin_tol*rr0)
+      break;
+    this->apply(m_p, m_Ap);
+    double pAp = 0.0;
+    for (int k = 0; k < n; k++)
+      pAp += m_p[k]*m_Ap[k];
+    if (pAp <= 0.0)
+    {
+      if (iter == 0)
+        for (int k = 0; k < n; k++)
+          m_dx[k] = m_r[k];
+      break;
+    }
+    double alpha = rr/pAp;
+    double rr_new = 0.0;
+    for (int k = 0; k < n; k++)
+    {
+      m_dx[k] += alpha*m_p[k];
+      m_r[k] -= alpha*m_Ap[k];
+      rr_new += m_r[k]*m_r[k];
+    }
+    double beta = rr_new/rr;
+    for (int k = 0; k < n; k++)
+      m_p[k] = m_r[k] + beta*m_p[k];
+    rr = rr_new;
+  }
+  return iter;
+}
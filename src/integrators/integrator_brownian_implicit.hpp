@@ -0,0 +1,236 @@
+/* ***************************************************************************
+ *
+ *  Copyright (C) 2013-2016 University of Dundee
+ *  All rights reserved. 
+ *
+ *  This file is part of SAMoS (Soft Active Matter on Surfaces) program.
+ *
+ *  SAMoS is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  SAMoS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ****************************************************************************/
+
+/*!
+ * \file integrator_brownian_implicit.hpp
+ * \author Rastko Sknepnek, sknepnek@gmail.com
+ * \date 18-Oct-2026
+ * \brief Declaration of IntegratorBrownianImplicit class
+ */ 
+
+#ifndef __INTEGRATOR_BROWNIAN_IMPLICIT_H__
+#define __INTEGRATOR_BROWNIAN_IMPLICIT_H__
+
+#include <cmath>
+#include <vector>
+
+#include "integrator.hpp"
+#include "rng.hpp"
+
+using std::sqrt;
+using std::fabs;
+using std::vector;
+
+/*! IntegratorBrownianImplicit class implements over-damped dynamics of the particle position
+ *  using the implicit (backward) Euler scheme,
+ *  \f$ \vec r^{n+1} = \vec r^n + \delta t\left(v_0\hat{\vec n}^n + \mu\vec F\left(\vec r^{n+1}\right)\right) + \sqrt{2\mu T\delta t}\vec\xi \f$.
+ *  Nonlinear equations are solved with the Jacobian-free Newton-Krylov method. Each Newton step 
+ *  solves \f$ \left(I - \delta t\mu J\right)\delta\vec r = -\vec R \f$ with conjugate gradients, where 
+ *  product of the force Jacobian \f$ J \f$ with a vector is approximated by a finite difference of forces.
+ *  This allows for much larger time steps for stiff systems, e.g., vertex model of tissues with large area stiffness.
+ *  \note Only interaction forces are treated implicitly. Self-propulsion \f$ v_0\hat{\vec n} \f$ 
+ *  uses the director at the beginning of the step, and the director is integrated explicitly 
+ *  after the position update in the same way as in IntegratorBrownian.
+*/
+class IntegratorBrownianImplicit : public Integrator
+{
+public:
+  
+  //! Constructor
+  //! \param sys Pointer to a System object containing all particles
+  //! \param msg Internal message handler
+  //! \param pot Pairwise and external interaction handler
+  //! \param align Pairwise and external alignment handler
+  //! \param nlist Neighbour list object
+  //! \param cons Enforces constraints to the manifold surface
+  //! \param temp Temperature control object
+  //! \param param Contains information about all parameters 
+  IntegratorBrownianImplicit(SystemPtr sys, MessengerPtr msg, PotentialPtr pot, AlignerPtr align, NeighbourListPtr nlist,  ConstrainerPtr cons, ValuePtr temp, pairs_type& param) : Integrator(sys, msg, pot, align, nlist, cons, temp, param),
+                                                                                                                                                                                    m_warned(false)
+  { 
+    m_known_params.push_back("v0");
+    m_known_params.push_back("nu");
+    m_known_params.push_back("mu");
+    m_known_params.push_back("mur");
+    m_known_params.push_back("seed");
+    m_known_params.push_back("newton_iter");
+    m_known_params.push_back("tol");
+    m_known_params.push_back("lin_iter");
+    m_known_params.push_back("lin_tol");
+    string param_test = this->params_ok(param);
+    if (param_test != "")
+    {
+      m_msg->msg(Messenger::ERROR,"Parameter \""+param_test+"\" is not a valid parameter for brownian_implicit integrator.");
+      throw runtime_error("Unknown parameter \""+param_test+"\" in brownian_implicit integrator.");
+    }
+    if (param.find("v0") == param.end())
+    {
+      m_msg->msg(Messenger::WARNING,"Implicit Brownian dynamics integrator. Active velocity v0 not specified. Using default value 0.");
+      m_v0 = 0.0;
+    }
+    else
+    {
+      m_msg->msg(Messenger::INFO,"Implicit Brownian dynamics integrator. Setting magnitude of active velocity to "+param["v0"]+".");
+      m_v0 = lexical_cast<double>(param["v0"]);
+    }
+    m_msg->write_config("integrator.brownian_implicit.v0",lexical_cast<string>(m_v0));
+    if (param.find("nu") == param.end())
+    {
+      m_msg->msg(Messenger::WARNING,"Implicit Brownian dynamics integrator. Rotational diffusion rate not set. Using default value 0.");
+      m_nu = 0.0;
+    }
+    else
+    {
+      m_msg->msg(Messenger::INFO,"Implicit Brownian dynamics integrator. Setting rotational diffusion rate to "+param["nu"]+".");
+      m_nu = lexical_cast<double>(param["nu"]);
+    }
+    m_msg->write_config("integrator.brownian_implicit.nu",lexical_cast<string>(m_nu));
+    if (param.find("mu") == param.end())
+    {
+      m_msg->msg(Messenger::WARNING,"Implicit Brownian dynamics integrator. Mobility not set. Using default value 1.");
+      m_mu = 1.0;
+    }
+    else
+    {
+      m_msg->msg(Messenger::INFO,"Implicit Brownian dynamics integrator. Setting mobility to "+param["mu"]+".");
+      m_mu = lexical_cast<double>(param["mu"]);
+    }
+    m_msg->write_config("integrator.brownian_implicit.mu",lexical_cast<string>(m_mu));
+    if (param.find("mur") == param.end())
+    {
+      m_msg->msg(Messenger::WARNING,"Implicit Brownian dynamics integrator. Rotational mobility not set. Using default value 1.");
+      m_mur = 1.0;
+    }
+    else
+    {
+      m_msg->msg(Messenger::INFO,"Implicit Brownian dynamics integrator. Setting rotational mobility to "+param["mur"]+".");
+      m_mur = lexical_cast<double>(param["mur"]);
+    }
+    m_msg->write_config("integrator.brownian_implicit.mur",lexical_cast<string>(m_mur));
+    if (param.find("seed") == param.end())
+    {
+      m_msg->msg(Messenger::WARNING,"Implicit Brownian dynamics integrator. No random number generator seed specified. Using default 0.");
+      m_rng = make_shared<RNG>(0,"integrator_brownian_implicit");
+      m_msg->write_config("integrator.brownian_implicit.seed",lexical_cast<string>(0));
+    }
+    else
+    {
+      m_msg->msg(Messenger::INFO,"Implicit Brownian dynamics integrator. Setting random number generator seed to "+param["seed"]+".");
+      m_rng = make_shared<RNG>(lexical_cast<int>(param["seed"]),"integrator_brownian_implicit");
+      m_msg->write_config("integrator.brownian_implicit.seed",param["seed"]);
+    }
+    if (param.find("newton_iter") == param.end())
+    {
+      m_msg->msg(Messenger::WARNING,"Implicit Brownian dynamics integrator. Maximum number of Newton iterations not set. Using default value 10.");
+      m_newton_iter = 10;
+    }
+    else
+    {
+      m_msg->msg(Messenger::INFO,"Implicit Brownian dynamics integrator. Setting maximum number of Newton iterations to "+param["newton_iter"]+".");
+      m_newton_iter = lexical_cast<int>(param["newton_iter"]);
+    }
+    m_msg->write_config("integrator.brownian_implicit.newton_iter",lexical_cast<string>(m_newton_iter));
+    if (param.find("tol") == param.end())
+    {
+      m_msg->msg(Messenger::WARNING,"Implicit Brownian dynamics integrator. Newton tolerance not set. Using default value 1e-8.");
+      m_tol = 1e-8;
+    }
+    else
+    {
+      m_msg->msg(Messenger::INFO,"Implicit Brownian dynamics integrator. Setting Newton tolerance to "+param["tol"]+".");
+      m_tol = lexical_cast<double>(param["tol"]);
+    }
+    m_msg->write_config("integrator.brownian_implicit.tol",lexical_cast<string>(m_tol));
+    if (param.find("lin_iter") == param.end())
+    {
+      m_msg->msg(Messenger::WARNING,"Implicit Brownian dynamics integrator. Maximum number of linear solver iterations not set. Using default value 50.");
+      m_lin_iter = 50;
+    }
+    else
+    {
+      m_msg->msg(Messenger::INFO,"Implicit Brownian dynamics integrator. Setting maximum number of linear solver iterations to "+param["lin_iter"]+".");
+      m_lin_iter = lexical_cast<int>(param["lin_iter"]);
+    }
+    m_msg->write_config("integrator.brownian_implicit.lin_iter",lexical_cast<string>(m_lin_iter));
+    if (param.find("lin_tol") == param.end())
+    {
+      m_msg->msg(Messenger::WARNING,"Implicit Brownian dynamics integrator. Relative tolerance of the linear solver not set. Using default value 1e-4.");
+      m_lin_tol = 1e-4;
+    }
+    else
+    {
+      m_msg->msg(Messenger::INFO,"Implicit Brownian dynamics integrator. Setting relative tolerance of the linear solver to "+param["lin_tol"]+".");
+      m_lin_tol = lexical_cast<double>(param["lin_tol"]);
+    }
+    m_msg->write_config("integrator.brownian_implicit.lin_tol",lexical_cast<string>(m_lin_tol));
+    m_stoch_coeff = sqrt(m_nu*m_dt);
+    if (m_newton_iter < 1 || m_lin_iter < 1)
+    {
+      m_msg->msg(Messenger::ERROR,"Implicit Brownian dynamics integrator. Number of Newton and linear solver iterations has to be at least 1.");
+      throw runtime_error("Invalid number of iterations in brownian_implicit integrator.");
+    }
+  }
+  
+  //! Propagate system for a time step
+  void integrate();
+  
+private:
+  
+  RNGPtr  m_rng;            //!< Random number generator 
+  double  m_v0;             //!< Magnitude of the active velocity 
+  double  m_nu;             //!< Rotational diffusion 
+  double  m_mu;             //!< Mobility 
+  double  m_mur;            //!< Rotational mobility
+  double  m_stoch_coeff;    //!< Factor for the stochastic part of the director equation (\f$ = \sqrt{\nu dt} \f$)
+  int     m_newton_iter;    //!< Maximum number of Newton iterations per time step
+  double  m_tol;            //!< Newton iterations stop once the largest component of the residual drops below this value
+  int     m_lin_iter;       //!< Maximum number of conjugate gradient iterations per Newton step
+  double  m_lin_tol;        //!< Relative tolerance of the conjugate gradient solver
+  bool    m_warned;         //!< If true, warning about Newton iterations not converging has already been issued
+  vector<int>    m_flags;   //!< Flags of all particles in the group (keys for the random streams)
+  vector<double> m_noise;   //!< Gaussian noise for the current step (four numbers per particle)
+  vector<double> m_x0;      //!< Positions at the beginning of the step (three per particle)
+  vector<double> m_a;       //!< Active displacement \f$ \delta t v_0\hat{\vec n} \f$ during the step (three per particle)
+  vector<double> m_x;       //!< Current Newton iterate
+  vector<double> m_xi;      //!< Random displacement during the step
+  vector<double> m_f;       //!< Forces at the current Newton iterate
+  vector<double> m_r;       //!< Residual (also used as the right hand side of the linear problem)
+  vector<double> m_dx;      //!< Newton update
+  vector<double> m_p;       //!< Search direction of the conjugate gradient solver
+  vector<double> m_Ap;      //!< Linear operator applied to the search direction
+  vector<double> m_xp;      //!< Perturbed positions used in the finite difference
+  vector<double> m_fp;      //!< Forces at perturbed positions
+  
+  //! Compute forces for given positions of particles in the group
+  void compute_forces(const vector<double>&, vector<double>&);
+  
+  //! Apply \f$ I - \delta t\mu J \f$ to a vector
+  void apply(const vector<double>&, vector<double>&);
+  
+  //! Solve linear problem for the Newton update
+  int solve();
+  
+};
+
+typedef shared_ptr<IntegratorBrownianImplicit> IntegratorBrownianImplicitPtr;
+
+#endif
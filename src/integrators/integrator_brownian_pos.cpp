@@ -41,7 +41,7 @@ void IntegratorBrownianPos::integrate()
   double B = sqrt(2.0*m_mu*T);
   double sqrt_dt = sqrt(m_dt);
   double fr_x = 0.0, fr_y = 0.0, fr_z = 0.0;  // Random part of the force
-  vector<int> particles = m_system->get_group(m_group_name)->get_particles();
+  const vector<int>& particles = m_system->get_group(m_group_name)->get_particles();
   
   // reset forces 
   m_system->reset_forces();
@@ -59,9 +59,7 @@ void IntegratorBrownianPos::integrate()
     p.vy = m_mu*p.fy;
     p.vz = m_mu*p.fz;
     // Update particle position 
-    p.x += m_dt*p.vx;
-    p.y += m_dt*p.vy;
-    p.z += m_dt*p.vz;
+    p.move(m_dt*p.vx, m_dt*p.vy, m_dt*p.vz);
     // Check is non-zero T and if non-zero add stochastic part
     if (T > 0.0)
     {
@@ -71,14 +69,12 @@ void IntegratorBrownianPos::integrate()
       p.vx += fr_x; 
       p.vy += fr_y;
       p.vz += fr_z;  
-      p.x += sqrt_dt*fr_x;
-      p.y += sqrt_dt*fr_y;
-      p.z += sqrt_dt*fr_z;
+      p.move(sqrt_dt*fr_x, sqrt_dt*fr_y, sqrt_dt*fr_z);
     }
-    // Project everything back to the manifold
-    m_constrainer->enforce(p);
     p.age += m_dt;
   }
+  // Project everything back to the manifold (once for the entire group)
+  m_constrainer->enforce(particles);
   // Update vertex mesh
   m_system->update_mesh();
 }
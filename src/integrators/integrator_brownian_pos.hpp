@@ -77,13 +77,13 @@ public:
     if (param.find("seed") == param.end())
     {
       m_msg->msg(Messenger::WARNING,"Brownian dynamics integrator for particle position. No random number generator seed specified. Using default 0.");
-      m_rng = make_shared<RNG>(0);
+      m_rng = make_shared<RNG>(0,"integrator_brownian_pos");
       m_msg->write_config("integrator.brownian_pos.seed",lexical_cast<string>(0));
     }
     else
     {
       m_msg->msg(Messenger::INFO,"Brownian dynamics integrator for particle position. Setting random number generator seed to "+param["seed"]+".");
-      m_rng = make_shared<RNG>(lexical_cast<int>(param["seed"]));
+      m_rng = make_shared<RNG>(lexical_cast<int>(param["seed"]),"integrator_brownian_pos");
       m_msg->write_config("integrator.brownian_pos.seed",param["seed"]);
     }
   }
@@ -38,7 +38,7 @@ void IntegratorBrownianRod::integrate()
   int N = m_system->get_group(m_group_name)->get_size();
   //double T = m_temp->get_val(m_system->get_run_step());
   double fd_x, fd_y, fd_z;                    // Deterministic part of the force
-  vector<int> particles = m_system->get_group(m_group_name)->get_particles();
+  const vector<int>& particles = m_system->get_group(m_group_name)->get_particles();
   double R1, R2;
   
   // reset forces and torques
@@ -87,9 +87,7 @@ void IntegratorBrownianRod::integrate()
     p.vy = fd_y;
     p.vz = fd_z;
     // Update particle position according to the eq. (1a)
-    p.x += m_dt*fd_x;
-    p.y += m_dt*fd_y;
-    p.z += m_dt*fd_z;
+    p.move(m_dt*fd_x, m_dt*fd_y, m_dt*fd_z);
     
     // Normal to the manifold
     double w1_x, w1_y, w1_z;
@@ -108,9 +106,10 @@ void IntegratorBrownianRod::integrate()
       R1 = m_rng->gauss_rng(1.0);
       R2 = m_rng->gauss_rng(1.0);
       
-      p.x += stoch_par*m_rng->gauss_rng(1.0)*nx + stoch_perp*(R1*w1_x + R2*w2_x);
-      p.y += stoch_par*m_rng->gauss_rng(1.0)*ny + stoch_perp*(R1*w1_y + R2*w2_y);
-      p.z += stoch_par*m_rng->gauss_rng(1.0)*nz + stoch_perp*(R1*w1_z + R2*w2_z);
+      double dx = stoch_par*m_rng->gauss_rng(1.0)*nx + stoch_perp*(R1*w1_x + R2*w2_x);
+      double dy = stoch_par*m_rng->gauss_rng(1.0)*ny + stoch_perp*(R1*w1_y + R2*w2_y);
+      double dz = stoch_par*m_rng->gauss_rng(1.0)*nz + stoch_perp*(R1*w1_z + R2*w2_z);
+      p.move(dx, dy, dz);
     }
     
     double stoch = sqrt(2.0*D_rot*m_dt);
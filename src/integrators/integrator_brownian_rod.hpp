@@ -80,13 +80,13 @@ public:
     if (param.find("seed") == param.end())
     {
       m_msg->msg(Messenger::WARNING,"Brownian rod dynamics integrator. No random number generator seed specified. Using default 0.");
-      m_rng = make_shared<RNG>(0);
+      m_rng = make_shared<RNG>(0,"integrator_brownian_rod");
       m_msg->write_config("integrator.brownian_rod.seed",lexical_cast<string>(0));
     }
     else
     {
       m_msg->msg(Messenger::INFO,"Brownian rod dynamics integrator. Setting random number generator seed to "+param["seed"]+".");
-      m_rng = make_shared<RNG>(lexical_cast<int>(param["seed"]));
+      m_rng = make_shared<RNG>(lexical_cast<int>(param["seed"]),"integrator_brownian_rod");
       m_msg->write_config("integrator.brownian_rod.seed",param["seed"]);
     }
     if (param.find("nematic") == param.end())
@@ -123,6 +123,18 @@ public:
   //! Propagate system for a time step
   void integrate();
   
+  //! Save state of the random number generator
+  //! \param ckp checkpoint writer
+  void write_checkpoint(CheckpointWriter& ckp) { m_rng->write_checkpoint(ckp); }
+  
+  //! Restore state of the random number generator
+  //! \param ckp checkpoint reader
+  void read_checkpoint(CheckpointReader& ckp) 
+  { 
+    if (!m_rng->read_checkpoint(ckp))
+      m_msg->msg(Messenger::WARNING,"Brownian rod dynamics integrator. Random number generator seed differs from the one in the checkpoint. Starting new random sequence.");
+  }
+  
 private:
   
   RNGPtr  m_rng;          //!< Random number generator 
@@ -30,6 +30,11 @@
 #include "integrator_fire.hpp"
 
 /*! This is the FIRE minimiser.  
+ *  If fire2 is set, FIRE 2.0 variant of Guenole, et al., Comp. Mat. Sci. 175, 109584 (2020) is used. 
+ *  It differs from the original algorithm in three points: velocities are mixed with forces 
+ *  right after the first half step for velocity, upon uphill motion (P <= 0) system is moved back by half a step,
+ *  and time step is not decreased during the first few (delay) steps and never below dt_min.
+ *  Energy (which is expensive to compute) and force norm are checked for convergence every check_every steps. 
 **/
 void IntegratorFIRE::integrate()
 {
@@ -37,13 +42,13 @@ void IntegratorFIRE::integrate()
   double E; 
   double Fnorm = 0.0;
   double Vnorm = 0.0;
-  double vx, vy, vz;
-  double ax, ay, az;
 
   int N = m_system->get_group(m_group_name)->get_size();
   double sqrt_ndof = sqrt(3*N);
-  vector<int> particles = m_system->get_group(m_group_name)->get_particles();
+  const vector<int>& particles = m_system->get_group(m_group_name)->get_particles();
   double dt_2 = 0.5*m_dt;
+  bool check = (m_step % m_check_every == 0);
+  m_step++;
   
   // Perform first half step for velocity
   for (int i = 0; i < N; i++)
@@ -53,10 +58,36 @@ void IntegratorFIRE::integrate()
     p.vx += dt_2*p.fx;
     p.vy += dt_2*p.fy;
     p.vz += dt_2*p.fz;
+  }
+  // FIRE 2.0 mixes velocities before updating positions
+  if (m_fire2)
+  {
+    double F2 = 0.0, V2 = 0.0;
+    for (int i = 0; i < N; i++)
+    {
+      Particle& p = m_system->get_particle(particles[i]);
+      F2 += p.fx*p.fx + p.fy*p.fy + p.fz*p.fz;
+      V2 += p.vx*p.vx + p.vy*p.vy + p.vz*p.vz;
+    }
+    if (F2 > 0.0)
+    {
+      double fact_1 = 1.0 - m_alpha;
+      double fact_2 = m_alpha*sqrt(V2/F2);
+      for (int i = 0; i < N; i++)
+      {
+        Particle& p = m_system->get_particle(particles[i]);
+        p.vx = fact_1*p.vx + fact_2*p.fx;
+        p.vy = fact_1*p.vy + fact_2*p.fy;
+        p.vz = fact_1*p.vz + fact_2*p.fz;
+      }
+    }
+  }
+  for (int i = 0; i < N; i++)
+  {
+    int pi = particles[i];
+    Particle& p = m_system->get_particle(pi);
     // Update position
-    p.x += m_dt*p.vx;
-    p.y += m_dt*p.vy;
-    p.z += m_dt*p.vz;
+    p.move(m_dt*p.vx, m_dt*p.vy, m_dt*p.vz);
     // Project everything back to the manifold
     m_constrainer->enforce(p);
     // Update angular velocity
@@ -98,26 +129,34 @@ void IntegratorFIRE::integrate()
   Fnorm = sqrt(Fnorm);
   Vnorm = sqrt(Vnorm);  
 
-  E = m_potential->compute_potential_energy();
-  cout << "E = " << E << "  Fnorm  = " << Fnorm/sqrt_ndof << "  Vnorm = " << Vnorm << endl;
-
-  if (Fnorm/sqrt_ndof < m_F_tol && fabs(E - m_old_energy) < m_E_tol)
+  if (check)
   {
-    m_converged = true;
-    m_msg->msg(Messenger::INFO,"FIRE minimisation converged.");
-    return;
+    E = m_potential->compute_potential_energy();
+    if (!m_quiet)
+      cout << "E = " << E << "  Fnorm  = " << Fnorm/sqrt_ndof << "  Vnorm = " << Vnorm << endl;
+
+    if (Fnorm/sqrt_ndof < m_F_tol && fabs(E - m_old_energy) < m_E_tol)
+    {
+      m_converged = true;
+      m_msg->msg(Messenger::INFO,"FIRE minimisation converged after "+lexical_cast<string>(m_step)+" steps.");
+      return;
+    }
+    m_old_energy = E;
   }
   
-  double inv_Fnorm = 1.0/Fnorm;
-  double fact_1 = 1.0 - m_alpha;
-  double fact_2 = m_alpha * inv_Fnorm * Vnorm;
-  for (int i = 0; i < N; i++)
+  if (!m_fire2)
   {
-    int pi = particles[i];
-    Particle& p = m_system->get_particle(pi);
-    p.vx = fact_1*p.vx + fact_2 * p.fx;
-    p.vy = fact_1*p.vy + fact_2 * p.fy;
-    p.vz = fact_1*p.vz + fact_2 * p.fz;
+    double inv_Fnorm = 1.0/Fnorm;
+    double fact_1 = 1.0 - m_alpha;
+    double fact_2 = m_alpha * inv_Fnorm * Vnorm;
+    for (int i = 0; i < N; i++)
+    {
+      int pi = particles[i];
+      Particle& p = m_system->get_particle(pi);
+      p.vx = fact_1*p.vx + fact_2 * p.fx;
+      p.vy = fact_1*p.vy + fact_2 * p.fy;
+      p.vz = fact_1*p.vz + fact_2 * p.fz;
+    }
   }
   
   if (P > 0.0)
@@ -131,18 +170,33 @@ void IntegratorFIRE::integrate()
   }
   else
   {
-    m_dt *= m_f_dec;
-    m_alpha = m_alpha_init;
+    if (!m_fire2)
+    {
+      m_dt *= m_f_dec;
+      m_alpha = m_alpha_init;
+    }
+    else if (m_step > m_N_delay)
+    {
+      m_dt = max(m_dt*m_f_dec, m_dt_min);
+      m_alpha = m_alpha_init;
+    }
     m_last_neg = 0;
     for (int i = 0; i < N; i++)
     {
       int pi = particles[i];
       Particle& p = m_system->get_particle(pi);
+      // FIRE 2.0 corrects for uphill motion by moving back half a step
+      if (m_fire2)
+      {
+        p.move(-0.5*m_dt*p.vx, -0.5*m_dt*p.vy, -0.5*m_dt*p.vz);
+        m_constrainer->enforce(p);
+      }
       p.vx = 0.0; p.vy = 0.0; p.vz = 0.0;
     }
+    if (m_fire2)
+      m_system->update_mesh();
   }
   
   m_converged = false;
-  m_old_energy = E;
 
 }
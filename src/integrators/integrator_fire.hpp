@@ -38,6 +38,7 @@
 using std::sqrt;
 using std::fabs;
 using std::min;
+using std::max;
 
 /*! IntegratorFIRE class handles FIRE minimization. 
  *  \note No activity. Just minimization. 
@@ -58,7 +59,8 @@ public:
   IntegratorFIRE(SystemPtr sys, MessengerPtr msg, PotentialPtr pot, AlignerPtr align, NeighbourListPtr nlist,  ConstrainerPtr cons, ValuePtr temp, pairs_type& param) : Integrator(sys, msg, pot, align, nlist, cons, temp, param),
                                                                                                                                                                         m_converged(false),
                                                                                                                                                                         m_old_energy(1e15),
-                                                                                                                                                                        m_last_neg(0)
+                                                                                                                                                                        m_last_neg(0),
+                                                                                                                                                                        m_step(0)
   { 
     m_msg->write_config("integrator.fire","");
     if (param.find("alpha") != param.end())
@@ -150,12 +152,92 @@ public:
       m_N_min = 5;
     }
     m_msg->write_config("integrator.FIRE.N_min",lexical_cast<string>(m_N_min));
-    
+    if (param.find("fire2") != param.end())
+    {
+      m_msg->msg(Messenger::INFO,"FIRE integrator. Using FIRE 2.0 variant of the algorithm.");
+      m_fire2 = true;
+    }
+    else
+      m_fire2 = false;
+    m_msg->write_config("integrator.FIRE.fire2",(m_fire2 ? "true" : "false"));
+    if (m_fire2)
+    {
+      if (param.find("delay") != param.end())
+      {
+        m_msg->msg(Messenger::INFO,"FIRE integrator number of initial steps during which step size is not decreased set to "+param["delay"]+".");
+        m_N_delay = lexical_cast<int>(param["delay"]);
+      }
+      else
+      {
+        m_msg->msg(Messenger::WARNING,"FIRE integrator number of initial steps during which step size is not decreased not set. Using default value of 20.");
+        m_N_delay = 20;
+      }
+      m_msg->write_config("integrator.FIRE.N_delay",lexical_cast<string>(m_N_delay));
+      if (param.find("dt_min") != param.end())
+      {
+        m_msg->msg(Messenger::INFO,"FIRE integrator minimum step size dt_min set to "+param["dt_min"]+".");
+        m_dt_min = lexical_cast<double>(param["dt_min"]);
+      }
+      else
+      {
+        m_dt_min = 0.02*m_dt;
+        m_msg->msg(Messenger::WARNING,"FIRE integrator minimum step size dt_min not set. Using default value of "+lexical_cast<string>(m_dt_min)+" (2% of initial step size).");
+      }
+      m_msg->write_config("integrator.FIRE.dt_min",lexical_cast<string>(m_dt_min));
+    }
+    else
+    {
+      m_N_delay = 0;
+      m_dt_min = 0.0;
+    }
+    if (param.find("check_every") != param.end())
+    {
+      m_msg->msg(Messenger::INFO,"FIRE integrator. Energy and force norm will be checked every "+param["check_every"]+" steps.");
+      m_check_every = lexical_cast<int>(param["check_every"]);
+    }
+    else
+    {
+      m_msg->msg(Messenger::WARNING,"FIRE integrator. Frequency of convergence checks not set. Checking every step.");
+      m_check_every = 1;
+    }
+    if (m_check_every < 1)
+    {
+      m_msg->msg(Messenger::ERROR,"FIRE integrator. Convergence has to be checked at least every step (check_every >= 1).");
+      throw runtime_error("Invalid value of check_every in FIRE integrator.");
+    }
+    m_msg->write_config("integrator.FIRE.check_every",lexical_cast<string>(m_check_every));
+    if (param.find("quiet") != param.end())
+    {
+      m_msg->msg(Messenger::INFO,"FIRE integrator. Energy and force norms will not be printed.");
+      m_quiet = true;
+    }
+    else
+      m_quiet = false;
+    m_msg->write_config("integrator.FIRE.quiet",(m_quiet ? "true" : "false"));
   }
   
   //! Propagate system for a time step
   void integrate();
   
+  //! Returns true if minimisation has converged
+  bool converged() { return m_converged; }
+  
+  //! Save adaptive parameters of the minimizer
+  //! \param ckp checkpoint writer
+  void write_checkpoint(CheckpointWriter& ckp)
+  {
+    ckp.write(m_dt);  ckp.write(m_alpha);  ckp.write(m_last_neg);  
+    ckp.write(m_old_energy);  ckp.write(m_converged);  ckp.write(m_step);
+  }
+  
+  //! Restore adaptive parameters of the minimizer
+  //! \param ckp checkpoint reader
+  void read_checkpoint(CheckpointReader& ckp)
+  {
+    ckp.read(m_dt);  ckp.read(m_alpha);  ckp.read(m_last_neg);  
+    ckp.read(m_old_energy);  ckp.read(m_converged);  ckp.read(m_step);
+  }
+  
 private:
 
   double m_alpha;                                   //!< alpha factor in the FIRE minimizer
@@ -170,6 +252,12 @@ private:
   double m_old_energy;                              //!< Old value of energy
   bool   m_converged;                               //!< Flag which tests if the method has converged
   double m_dt_max;                                  //!< Maximum time step
+  double m_dt_min;                                  //!< Minimum time step (FIRE 2.0)
+  int    m_N_delay;                                 //!< Number of initial steps during which time step is not decreased (FIRE 2.0)
+  bool   m_fire2;                                   //!< If true, use FIRE 2.0 variant of the algorithm
+  int    m_check_every;                             //!< Check energy and force norm (convergence) every this many steps
+  bool   m_quiet;                                   //!< If true, do not print energy and force norms
+  int    m_step;                                    //!< Number of steps made by the minimiser
 
   
 };
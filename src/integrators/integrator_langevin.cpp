@@ -31,6 +31,12 @@
 
 void IntegratorLangevin::integrate()
 {
+  // choose time step such that no particle moves too far 
+  if (m_adaptive)
+  {
+    m_dt = this->adapt_step();
+    m_system->set_current_step(m_dt);  // populations use the step actually made
+  }
   if (m_method == "baoab")
     this->integrate_baoab();
   else if (m_method == "spv")
@@ -39,6 +45,7 @@ void IntegratorLangevin::integrate()
     this->integrate_bbk();
   else
     throw runtime_error("Unknown integration method");
+  this->advance_run_time();
 }
 
 // Private methods
@@ -54,13 +61,18 @@ void IntegratorLangevin::integrate()
 void IntegratorLangevin::integrate_baoab()
 {
   int N = m_system->get_group(m_group_name)->get_size();
-  double T = m_temp->get_val(m_system->get_run_step());
+  double T = m_temp->get_val(this->schedule_step());
   double B = sqrt(T*(1.0-exp(-2.0*m_gamma*m_dt)));
   double exp_dt = exp(-m_gamma*m_dt);
   double dt2 = 0.5*m_dt;
-  vector<int> particles = m_system->get_group(m_group_name)->get_particles();
+  int step = m_system->get_step();
+  const vector<int>& particles = m_system->get_group(m_group_name)->get_particles();
 
+  if (B != 0.0)
+    this->generate_noise(particles, step);
+  
   // BAOA steps
+  #pragma omp parallel for
   for (int i = 0; i < N; i++)
   {
     int pi = particles[i];
@@ -71,11 +83,15 @@ void IntegratorLangevin::integrate_baoab()
     p.vy += fact*p.fy;
     p.vz += fact*p.fz;
     // A step
-    p.x += dt2*p.vx;
-    p.y += dt2*p.vy;
-    p.z += dt2*p.vz;
-    // Project everything back to the manifold
-    m_constrainer->enforce(p);
+    p.move(dt2*p.vx, dt2*p.vy, dt2*p.vz);
+  }
+  // Project everything back to the manifold (once for the entire group)
+  m_constrainer->enforce(particles);
+  #pragma omp parallel for
+  for (int i = 0; i < N; i++)
+  {
+    int pi = particles[i];
+    Particle& p = m_system->get_particle(pi);
     // O step
     p.vx *= exp_dt;
     p.vy *= exp_dt;
@@ -83,26 +99,25 @@ void IntegratorLangevin::integrate_baoab()
     if (B != 0.0)
     {
       double stoch_fact = B/sqrt(p.mass);
-      p.vx += stoch_fact*m_rng->gauss_rng(1.0);
-      p.vy += stoch_fact*m_rng->gauss_rng(1.0);
-      p.vz += stoch_fact*m_rng->gauss_rng(1.0);
+      p.vx += stoch_fact*m_noise[4*i];
+      p.vy += stoch_fact*m_noise[4*i+1];
+      p.vz += stoch_fact*m_noise[4*i+2];
     }
     // A step
-    p.x += dt2*p.vx;
-    p.y += dt2*p.vy;
-    p.z += dt2*p.vz;
-    // Project everything back to the manifold
-    m_constrainer->enforce(p);
+    p.move(dt2*p.vx, dt2*p.vy, dt2*p.vz);
   }
+  // Project everything back to the manifold (once for the entire group)
+  m_constrainer->enforce(particles);
   
   // reset forces 
   m_system->reset_forces();
   
   // compute forces in the current configuration
   if (m_potential)
-    m_potential->compute(m_dt);
+    m_potential->compute(m_dt_ref);
   
   // B step
+  #pragma omp parallel for
   for (int i = 0; i < N; i++)
   {
     int pi = particles[i];
@@ -128,35 +143,39 @@ void IntegratorLangevin::integrate_baoab()
 void IntegratorLangevin::integrate_spv()
 {
   int N = m_system->get_group(m_group_name)->get_size();
-  double T = m_temp->get_val(m_system->get_run_step());
+  double T = m_temp->get_val(this->schedule_step());
   double zeta = sqrt(T*(1.0-exp(-2.0*m_gamma*m_dt)));
   double eta;
   if (m_gamma == 0.0) eta = 0.0;
   else eta = (1.0-exp(-m_dt*m_gamma))/m_gamma;
   double exp_dt = exp(-m_dt*m_gamma);
   double dt2 = 0.5*m_dt;
-  vector<int> particles = m_system->get_group(m_group_name)->get_particles();
+  int step = m_system->get_step();
+  const vector<int>& particles = m_system->get_group(m_group_name)->get_particles();
   
   // Step 1
+  #pragma omp parallel for
   for (int i = 0; i < N; i++)
   {
     int pi = particles[i];
     Particle& p = m_system->get_particle(pi);
-    p.x += dt2*p.vx;
-    p.y += dt2*p.vy;
-    p.z += dt2*p.vz;
-    // Project everything back to the manifold
-    m_constrainer->enforce(p);
+    p.move(dt2*p.vx, dt2*p.vy, dt2*p.vz);
   }
+  // Project everything back to the manifold (once for the entire group)
+  m_constrainer->enforce(particles);
 
   // reset forces 
   m_system->reset_forces();
   
   // compute forces in the current configuration
   if (m_potential)
-    m_potential->compute(m_dt);
+    m_potential->compute(m_dt_ref);
 
+  if (zeta != 0.0)
+    this->generate_noise(particles, step);
+  
   // Steps 2 and 3
+  #pragma omp parallel for
   for (int i = 0; i < N; i++)
   {
     int pi = particles[i];
@@ -168,18 +187,16 @@ void IntegratorLangevin::integrate_spv()
     if (zeta != 0.0)
     {
       double stoch_fact = zeta/sqrt(p.mass);
-      p.vx += stoch_fact*m_rng->gauss_rng(1.0);
-      p.vy += stoch_fact*m_rng->gauss_rng(1.0);
-      p.vz += stoch_fact*m_rng->gauss_rng(1.0);
+      p.vx += stoch_fact*m_noise[4*i];
+      p.vy += stoch_fact*m_noise[4*i+1];
+      p.vz += stoch_fact*m_noise[4*i+2];
     }
     // Step 3
-    p.x += dt2*p.vx;
-    p.y += dt2*p.vy;
-    p.z += dt2*p.vz;
-    // Project everything back to the manifold
-    m_constrainer->enforce(p);
+    p.move(dt2*p.vx, dt2*p.vy, dt2*p.vz);
     p.age += m_dt;
   }
+  // Project everything back to the manifold (once for the entire group)
+  m_constrainer->enforce(particles);
 }
 
 /*! Integrates stochastic equations of motion using Langevin dynamics.
@@ -193,14 +210,16 @@ void IntegratorLangevin::integrate_spv()
 void IntegratorLangevin::integrate_bbk()
 {
   int N = m_system->get_group(m_group_name)->get_size();
-  double T = m_temp->get_val(m_system->get_run_step());
+  double T = m_temp->get_val(this->schedule_step());
   double B = sqrt(2.0*T*m_dt*m_gamma);
   double dt2 = 0.5*m_dt;
   double one_m_dt2 = 1.0 - m_gamma*dt2;
   double one_div_one_p_dt2 = 1.0/(1.0 + m_gamma*dt2);
-  vector<int> particles = m_system->get_group(m_group_name)->get_particles();
+  int step = m_system->get_step();
+  const vector<int>& particles = m_system->get_group(m_group_name)->get_particles();
   
   // Steps 1 and 2
+  #pragma omp parallel for
   for (int i = 0; i < N; i++)
   {
     int pi = particles[i];
@@ -216,20 +235,22 @@ void IntegratorLangevin::integrate_bbk()
       p.vy += stoch_fact*m_Ry[i];
       p.vz += stoch_fact*m_Rz[i];
     }
-    p.x += m_dt*p.vx;
-    p.y += m_dt*p.vy;
-    p.z += m_dt*p.vz;
-    // Project everything back to the manifold
-    m_constrainer->enforce(p);
+    p.move(m_dt*p.vx, m_dt*p.vy, m_dt*p.vz);
   }
+  // Project everything back to the manifold (once for the entire group)
+  m_constrainer->enforce(particles);
 
   // reset forces 
   m_system->reset_forces();
   
   // compute forces in the current configuration
   if (m_potential)
-    m_potential->compute(m_dt);
+    m_potential->compute(m_dt_ref);
 
+  if (B != 0.0)
+    this->generate_noise(particles, step);
+  
+  #pragma omp parallel for
   for (int i = 0; i < N; i++)
   {
     int pi = particles[i];
@@ -241,9 +262,9 @@ void IntegratorLangevin::integrate_bbk()
     if (B != 0.0)
     {
       double stoch_fact = 0.5*B*one_div_one_p_dt2/sqrt(p.mass);
-      m_Rx[i] = m_rng->gauss_rng(1.0);
-      m_Ry[i] = m_rng->gauss_rng(1.0);
-      m_Rz[i] = m_rng->gauss_rng(1.0);
+      m_Rx[i] = m_noise[4*i];
+      m_Ry[i] = m_noise[4*i+1];
+      m_Rz[i] = m_noise[4*i+2];
       p.vx += stoch_fact*m_Rx[i];
       p.vy += stoch_fact*m_Ry[i];
       p.vz += stoch_fact*m_Rz[i];
@@ -251,3 +272,41 @@ void IntegratorLangevin::integrate_bbk()
     }
   }
 }
+
+/*! Estimates displacement of each particle from its current velocity and force as
+ *  \f$ \Delta\vec r_i = dt\left(\vec v_i + \frac{dt}{2m_i}\vec F_i\right) \f$.
+ *  Contribution of the velocity noise, which is of order \f$ dt^{3/2} \f$, is ignored.
+ *  \param dt trial time step
+ */
+double IntegratorLangevin::max_disp_ratio(double dt)
+{
+  int N = m_system->get_group(m_group_name)->get_size();
+  const vector<int>& particles = m_system->get_group(m_group_name)->get_particles();
+  double ratio = 0.0;
+  for (int i = 0; i < N; i++)
+  {
+    Particle& p = m_system->get_particle(particles[i]);
+    double fact = 0.5*dt/p.mass;
+    double dx = dt*(p.vx + fact*p.fx);
+    double dy = dt*(p.vy + fact*p.fy);
+    double dz = dt*(p.vz + fact*p.fz);
+    double r = sqrt(dx*dx + dy*dy + dz*dz)/this->max_allowed_disp(p);
+    if (r > ratio) ratio = r;
+  }
+  return ratio;
+}
+
+/*! Generate Gaussian noise for all particles in the group in a single batch.
+ *  Noise for particle i in the group is stored in m_noise[4*i], ..., m_noise[4*i+2].
+ *  \param particles list of particles in the group
+ *  \param step current time step
+ */
+void IntegratorLangevin::generate_noise(const vector<int>& particles, int step)
+{
+  int N = particles.size();
+  m_flags.resize(N);
+  #pragma omp parallel for
+  for (int i = 0; i < N; i++)
+    m_flags[i] = m_system->get_particle(particles[i]).get_flag();
+  m_rng->gauss_rng(1.0, m_flags, step, 0, m_noise);
+}
@@ -67,6 +67,7 @@ public:
     m_known_params.push_back("gamma");
     m_known_params.push_back("seed");
     m_known_params.push_back("method");
+    this->add_adaptive_params();
     string param_test = this->params_ok(param);
     if (param_test != "")
     {
@@ -87,13 +88,13 @@ public:
     if (param.find("seed") == param.end())
     {
       m_msg->msg(Messenger::WARNING,"Langevin dynamics integrator for particle position. No random number generator seed specified. Using default 0.");
-      m_rng = make_shared<RNG>(0);
+      m_rng = make_shared<RNG>(0,"integrator_langevin");
       m_msg->write_config("integrator.langevin.seed",lexical_cast<string>(0));
     }
     else
     {
       m_msg->msg(Messenger::INFO,"Langevin dynamics integrator for particle position. Setting random number generator seed to "+param["seed"]+".");
-      m_rng = make_shared<RNG>(lexical_cast<int>(param["seed"]));
+      m_rng = make_shared<RNG>(lexical_cast<int>(param["seed"]),"integrator_langevin");
       m_msg->write_config("integrator.langevin.seed",param["seed"]);
     }
     if (param.find("method") == param.end())
@@ -117,6 +118,7 @@ public:
       }
     }
     m_msg->write_config("integrator.langevin.method",m_method);
+    this->read_adaptive_params(param,"langevin");
   }
 
   virtual ~IntegratorLangevin()
@@ -127,6 +129,24 @@ public:
   //! Propagate system for a time step
   void integrate();
   
+  //! Save current time step (if it is adaptive)
+  //! \param ckp checkpoint writer
+  void write_checkpoint(CheckpointWriter& ckp)
+  {
+    if (m_adaptive) ckp.write(m_dt);
+  }
+  
+  //! Restore current time step (if it is adaptive)
+  //! \param ckp checkpoint reader
+  void read_checkpoint(CheckpointReader& ckp)
+  {
+    if (m_adaptive)
+    {
+      ckp.read(m_dt);
+      m_system->set_current_step(m_dt);
+    }
+  }
+  
 private:
   
   RNGPtr  m_rng;             //!< Random number generator 
@@ -135,6 +155,14 @@ private:
   vector<double>  m_Rx;      //!< Normally distributed random numbers for BBK integrator
   vector<double>  m_Ry;      //!< Normally distributed random numbers for BBK integrator
   vector<double>  m_Rz;      //!< Normally distributed random numbers for BBK integrator
+  vector<int>     m_flags;   //!< Flags of all particles in the group (keys for the random streams)
+  vector<double>  m_noise;   //!< Gaussian noise for the current step (four numbers per particle, the last one is not used)
+  
+  //! Largest ratio of displacement to its allowed value for a step of size dt (uses current velocities and forces)
+  double max_disp_ratio(double);
+  
+  //! Generate noise for all particles in the group
+  void generate_noise(const vector<int>&, int);
 
   //! Integrate using BAOAB method (defualt)
   void integrate_baoab();
@@ -45,7 +45,8 @@
 void IntegratorNematic::integrate()
 {
   int N = m_system->get_group(m_group_name)->get_size();
-  vector<int> particles = m_system->get_group(m_group_name)->get_particles();
+  int step = m_system->get_step();
+  const vector<int>& particles = m_system->get_group(m_group_name)->get_particles();
   // reset forces and torques
   m_system->reset_forces();
   m_system->reset_torques();
@@ -53,28 +54,33 @@ void IntegratorNematic::integrate()
   // No need to compute potential, only compute torques in the current configuration
   if (m_align)
     m_align->compute();
-  // iterate over all particles 
+  // iterate over all particles (particles are independent, so the loop can run in parallel)
+  #pragma omp parallel for
   for (int i = 0; i < N; i++)
   {
     int pi = particles[i];
     Particle& p = m_system->get_particle(pi);
     // Update particle position 
-    double kappa = m_rng->drnd()-0.5;
+    double kappa = m_rng->drnd(p.get_flag(), step, 0)-0.5;
     if (kappa != 0.0)
       kappa /= fabs(kappa);
     else
       kappa = 0.0;
     kappa *= m_d0;
-    p.x += kappa*p.nx;
-    p.y += kappa*p.ny;
-    p.z += kappa*p.nz;
-    // Project everything back to the manifold
-    m_constrainer->enforce(p);
+    p.move(kappa*p.nx, kappa*p.ny, kappa*p.nz);
+  }
+  // Project everything back to the manifold (once for the entire group)
+  m_constrainer->enforce(particles);
+  #pragma omp parallel for
+  for (int i = 0; i < N; i++)
+  {
+    int pi = particles[i];
+    Particle& p = m_system->get_particle(pi);
     // Update angular velocity
     p.omega = m_mu*m_constrainer->project_torque(p);
     //p.omega = m_dt*m_constraint->project_torque(p);
     // Change orientation of the director (in the tangent plane) according to eq. (1b)
-    double dtheta = m_dt*p.omega + m_stoch_coeff*m_rng->gauss_rng(1.0);
+    double dtheta = m_dt*p.omega + m_stoch_coeff*m_rng->gauss_rng(1.0, p.get_flag(), step, 1);
     //double dtheta = m_dt*m_constraint->project_torque(p) + m_stoch_coeff*m_rng->gauss_rng(1.0);
     m_constrainer->rotate_director(p,dtheta);
     //p.omega = dtheta*m_dt;
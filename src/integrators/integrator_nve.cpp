@@ -37,11 +37,12 @@
 void IntegratorNVE::integrate()
 {
   int N = m_system->get_group(m_group_name)->get_size();
-  vector<int> particles = m_system->get_group(m_group_name)->get_particles();
+  const vector<int>& particles = m_system->get_group(m_group_name)->get_particles();
   double dt_2 = 0.5*m_dt;
   
   
   // Perform first half step for velocity
+  #pragma omp parallel for
   for (int i = 0; i < N; i++)
   {
     int pi = particles[i];
@@ -50,12 +51,19 @@ void IntegratorNVE::integrate()
     p.vx += dt_2*p.fx;
     p.vy += dt_2*p.fy;
     p.vz += dt_2*p.fz;
-    // Project everything back to the manifold
-    m_constrainer->enforce(p);
+  }
+  // Project everything back to the manifold (once for the entire group)
+  m_constrainer->enforce(particles);
+  #pragma omp parallel for
+  for (int i = 0; i < N; i++)
+  {
+    int pi = particles[i];
+    Particle& p = m_system->get_particle(pi);
     // Update angular velocity
     p.omega += dt_2*m_constrainer->project_torque(p);
   }
   // update position
+  #pragma omp parallel for
   for (int i = 0; i < N; i++)
   {
     int pi = particles[i];
@@ -74,14 +82,13 @@ void IntegratorNVE::integrate()
         dz = m_limit*dz/dr;
       }
     }
-    p.x += dx;
-    p.y += dy; 
-    p.z += dz;
-    // Project everything back to the manifold
-    m_constrainer->enforce(p);
+    p.move(dx, dy, dz);
   }
+  // Project everything back to the manifold (once for the entire group)
+  m_constrainer->enforce(particles);
 
   // Enforce constraints and update alignment
+  #pragma omp parallel for
   for (int i = 0; i < N; i++)
   {
     int pi = particles[i];
@@ -108,6 +115,7 @@ void IntegratorNVE::integrate()
     m_align->compute();
   
   // Perform second half step for velocity only if there is no limit on particle move
+  #pragma omp parallel for
   for (int i = 0; i < N; i++)
   {
     int pi = particles[i];
@@ -127,8 +135,14 @@ void IntegratorNVE::integrate()
         p.vz = p.vx/v*m_limit/m_dt;
       }
     }
-    // Project everything back to the manifold
-    m_constrainer->enforce(p);
+  }
+  // Project everything back to the manifold (once for the entire group)
+  m_constrainer->enforce(particles);
+  #pragma omp parallel for
+  for (int i = 0; i < N; i++)
+  {
+    int pi = particles[i];
+    Particle& p = m_system->get_particle(pi);
     // Update angular velocity
     p.omega += dt_2*m_constrainer->project_torque(p);
     if (m_has_limit)
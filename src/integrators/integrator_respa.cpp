@@ -0,0 +1,205 @@
+/* ***************************************************************************
+ *
+ *  Copyright (C) 2013-2016 University of Dundee
+ *  All rights reserved. 
+ *
+ *  This file is part of SAMoS (Soft Active Matter on Surfaces) program.
+ *
+ *  SAMoS is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  SAMoS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ****************************************************************************/
+
+/*!
+ * \file integrator_respa.cpp
+ * \author Rastko Sknepnek, sknepnek@gmail.com
+ * \date 18-Oct-2026
+ * \brief Implementation of the RESPA multiple time step integrator.
+ */ 
+
+#include "integrator_respa.hpp"
+
+/*! Integrates equations of motion using the r-RESPA factorisation 
+ *  of the Liouville operator. One call to this function advances the 
+ *  system by m_dt as:
+ *  -# half kick with the slow forces (\f$ \frac{\delta t}{2} \f$)
+ *  -# m_inner_steps velocity Verlet steps of size \f$ \delta t/k \f$ with the fast forces
+ *  -# recompute slow forces and torques
+ *  -# half kick with the slow forces (\f$ \frac{\delta t}{2} \f$)
+ *
+ *  Only forces of the fast class are evaluated in the inner loop. 
+ *  Slow forces (and alignment torques) are evaluated once per step.
+**/
+void IntegratorRESPA::integrate()
+{
+  int N = m_system->get_group(m_group_name)->get_size();
+  const vector<int>& particles = m_system->get_group(m_group_name)->get_particles();
+  double dt_2 = 0.5*m_dt;
+  double dt_inner_2 = 0.5*m_dt_inner;
+  
+  // Forces have not been computed yet or particles have been added or removed since the last step 
+  if (!m_initialised || static_cast<int>(m_fast_x.size()) != m_system->size())
+  {
+    this->compute_fast();
+    this->compute_slow();
+    m_initialised = true;
+  }
+  
+  // Outer half kick with slow forces
+  #pragma omp parallel for
+  for (int i = 0; i < N; i++)
+  {
+    int pi = particles[i];
+    Particle& p = m_system->get_particle(pi);
+    p.vx += dt_2*m_slow_x[pi];
+    p.vy += dt_2*m_slow_y[pi];
+    p.vz += dt_2*m_slow_z[pi];
+  }
+  // Project everything back to the manifold (once for the entire group)
+  m_constrainer->enforce(particles);
+  #pragma omp parallel for
+  for (int i = 0; i < N; i++)
+  {
+    int pi = particles[i];
+    Particle& p = m_system->get_particle(pi);
+    // Update angular velocity
+    p.omega += dt_2*m_constrainer->project_torque(p);
+  }
+  
+  // Inner velocity Verlet loop with fast forces
+  for (int step = 0; step < m_inner_steps; step++)
+  {
+    #pragma omp parallel for
+    for (int i = 0; i < N; i++)
+    {
+      int pi = particles[i];
+      Particle& p = m_system->get_particle(pi);
+      p.vx += dt_inner_2*m_fast_x[pi];
+      p.vy += dt_inner_2*m_fast_y[pi];
+      p.vz += dt_inner_2*m_fast_z[pi];
+      p.move(m_dt_inner*p.vx, m_dt_inner*p.vy, m_dt_inner*p.vz);
+    }
+    // Project everything back to the manifold (once for the entire group)
+    m_constrainer->enforce(particles);
+    this->compute_fast();
+    #pragma omp parallel for
+    for (int i = 0; i < N; i++)
+    {
+      int pi = particles[i];
+      Particle& p = m_system->get_particle(pi);
+      p.vx += dt_inner_2*m_fast_x[pi];
+      p.vy += dt_inner_2*m_fast_y[pi];
+      p.vz += dt_inner_2*m_fast_z[pi];
+    }
+    // Project everything back to the manifold (once for the entire group)
+    m_constrainer->enforce(particles);
+  }
+  
+  // Update director
+  #pragma omp parallel for
+  for (int i = 0; i < N; i++)
+  {
+    int pi = particles[i];
+    Particle& p = m_system->get_particle(pi);
+    m_constrainer->rotate_director(p,m_dt*p.omega);
+  }
+  
+  // Compute slow forces in the new configuration
+  this->compute_slow();
+  
+  // Outer half kick with slow forces
+  #pragma omp parallel for
+  for (int i = 0; i < N; i++)
+  {
+    int pi = particles[i];
+    Particle& p = m_system->get_particle(pi);
+    p.vx += dt_2*m_slow_x[pi];
+    p.vy += dt_2*m_slow_y[pi];
+    p.vz += dt_2*m_slow_z[pi];
+  }
+  // Project everything back to the manifold (once for the entire group)
+  m_constrainer->enforce(particles);
+  #pragma omp parallel for
+  for (int i = 0; i < N; i++)
+  {
+    int pi = particles[i];
+    Particle& p = m_system->get_particle(pi);
+    // Update angular velocity
+    p.omega += dt_2*m_constrainer->project_torque(p);
+    p.age += m_dt;
+  }
+  
+  // Particle forces hold the total force (used by logs and dumps)
+  for (int i = 0; i < m_system->size(); i++)
+  {
+    Particle& p = m_system->get_particle(i);
+    p.fx = m_fast_x[i] + m_slow_x[i];
+    p.fy = m_fast_y[i] + m_slow_y[i];
+    p.fz = m_fast_z[i] + m_slow_z[i];
+  }
+  
+  // Update vertex mesh
+  m_system->update_mesh();
+}
+
+// Private methods
+
+/*! Reset all forces and compute those that belong to the fast class.
+ *  Resulting forces are stored in m_fast_x, m_fast_y and m_fast_z.
+ */
+void IntegratorRESPA::compute_fast()
+{
+  int N = m_system->size();
+  m_system->reset_forces();
+  if (m_potential)
+  {
+    if (m_pair_fast) m_potential->compute_pair(m_dt_inner);
+    if (m_external_fast) m_potential->compute_external();
+    if (m_bond_fast) m_potential->compute_bond();
+    if (m_angle_fast) m_potential->compute_angle();
+  }
+  m_fast_x.resize(N);  m_fast_y.resize(N);  m_fast_z.resize(N);
+  #pragma omp parallel for
+  for (int i = 0; i < N; i++)
+  {
+    Particle& p = m_system->get_particle(i);
+    m_fast_x[i] = p.fx;  m_fast_y[i] = p.fy;  m_fast_z[i] = p.fz;
+  }
+}
+
+/*! Reset all forces and torques and compute forces that belong to the 
+ *  slow class together with all alignment torques.
+ *  Resulting forces are stored in m_slow_x, m_slow_y and m_slow_z.
+ */
+void IntegratorRESPA::compute_slow()
+{
+  int N = m_system->size();
+  m_system->reset_forces();
+  m_system->reset_torques();
+  if (m_potential)
+  {
+    if (!m_pair_fast) m_potential->compute_pair(m_dt);
+    if (!m_external_fast) m_potential->compute_external();
+    if (!m_bond_fast) m_potential->compute_bond();
+    if (!m_angle_fast) m_potential->compute_angle();
+  }
+  if (m_align)
+    m_align->compute();
+  m_slow_x.resize(N);  m_slow_y.resize(N);  m_slow_z.resize(N);
+  #pragma omp parallel for
+  for (int i = 0; i < N; i++)
+  {
+    Particle& p = m_system->get_particle(i);
+    m_slow_x[i] = p.fx;  m_slow_y[i] = p.fy;  m_slow_z[i] = p.fz;
+  }
+}
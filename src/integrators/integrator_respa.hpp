@@ -0,0 +1,155 @@
+/* ***************************************************************************
+ *
+ *  Copyright (C) 2013-2016 University of Dundee
+ *  All rights reserved. 
+ *
+ *  This file is part of SAMoS (Soft Active Matter on Surfaces) program.
+ *
+ *  SAMoS is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  SAMoS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ****************************************************************************/
+
+/*!
+ * \file integrator_respa.hpp
+ * \author Rastko Sknepnek, sknepnek@gmail.com
+ * \date 18-Oct-2026
+ * \brief Declaration of IntegratorRESPA class
+ */ 
+
+#ifndef __INTEGRATOR_RESPA_H__
+#define __INTEGRATOR_RESPA_H__
+
+#include <cmath>
+#include <vector>
+
+#include "integrator.hpp"
+
+using std::sqrt;
+using std::vector;
+
+/*! IntegratorRESPA class implements the reversible reference system propagator 
+ *  (r-RESPA) multiple time step scheme of Tuckerman, Berne and Martyna, J. Chem. Phys. 97, 1990 (1992).
+ *  Forces are split into fast (typically stiff bonds and angles) and slow 
+ *  (typically pair interactions, external forces and alignment) classes. Slow forces 
+ *  are evaluated once per time step dt, while fast forces are integrated with the 
+ *  velocity Verlet scheme using inner_steps substeps of size dt/inner_steps.
+ *  Each force class (pair, external, bond and angle) can be assigned to either 
+ *  the fast or the slow part. Alignment is always treated as slow.
+ *  \note No activity. Pure MD.
+*/
+class IntegratorRESPA : public Integrator
+{
+public:
+  
+  //! Constructor
+  //! \param sys Pointer to a System object containing all particles
+  //! \param msg Internal message handler
+  //! \param pot Pairwise and external interaction handler
+  //! \param align Pairwise and external alignment handler
+  //! \param nlist Neighbour list object
+  //! \param cons Enforces constraints to the manifold surface
+  //! \param temp Temperature control object
+  //! \param param Contains information about all parameters 
+  IntegratorRESPA(SystemPtr sys, MessengerPtr msg, PotentialPtr pot, AlignerPtr align, NeighbourListPtr nlist,  ConstrainerPtr cons, ValuePtr temp, pairs_type& param) : Integrator(sys, msg, pot, align, nlist, cons, temp, param),
+                                                                                                                                                                         m_initialised(false)
+  { 
+    m_known_params.push_back("inner_steps");
+    m_known_params.push_back("pair");
+    m_known_params.push_back("external");
+    m_known_params.push_back("bond");
+    m_known_params.push_back("angle");
+    string param_test = this->params_ok(param);
+    if (param_test != "")
+    {
+      m_msg->msg(Messenger::ERROR,"Parameter \""+param_test+"\" is not a valid parameter for RESPA integrator.");
+      throw runtime_error("Unknown parameter \""+param_test+"\" in RESPA integrator.");
+    }
+    m_msg->write_config("integrator.respa","");
+    if (param.find("inner_steps") == param.end())
+    {
+      m_msg->msg(Messenger::WARNING,"RESPA integrator. Number of inner steps not set. Using default value 4.");
+      m_inner_steps = 4;
+    }
+    else
+    {
+      m_msg->msg(Messenger::INFO,"RESPA integrator. Setting number of inner steps to "+param["inner_steps"]+".");
+      m_inner_steps = lexical_cast<int>(param["inner_steps"]);
+    }
+    if (m_inner_steps < 1)
+    {
+      m_msg->msg(Messenger::ERROR,"RESPA integrator. Number of inner steps has to be at least 1.");
+      throw runtime_error("Invalid number of RESPA inner steps.");
+    }
+    m_msg->write_config("integrator.respa.inner_steps",lexical_cast<string>(m_inner_steps));
+    m_pair_fast = this->is_fast(param, "pair", false);
+    m_external_fast = this->is_fast(param, "external", false);
+    m_bond_fast = this->is_fast(param, "bond", true);
+    m_angle_fast = this->is_fast(param, "angle", true);
+    m_dt_inner = m_dt/m_inner_steps;
+    m_msg->msg(Messenger::INFO,"RESPA integrator. Inner time step is "+lexical_cast<string>(m_dt_inner)+".");
+  }
+  
+  //! Propagate system for a time step
+  void integrate();
+  
+private:
+
+  int     m_inner_steps;        //!< Number of inner (fast) steps per one outer (slow) step
+  double  m_dt_inner;           //!< Inner time step (m_dt/m_inner_steps)
+  bool    m_pair_fast;          //!< If true, pair forces are integrated in the inner loop
+  bool    m_external_fast;      //!< If true, external forces are integrated in the inner loop
+  bool    m_bond_fast;          //!< If true, bond forces are integrated in the inner loop
+  bool    m_angle_fast;         //!< If true, angle forces are integrated in the inner loop
+  bool    m_initialised;        //!< If false, fast and slow forces have not been computed yet
+  vector<double> m_fast_x;      //!< x component of the fast force on each particle
+  vector<double> m_fast_y;      //!< y component of the fast force on each particle
+  vector<double> m_fast_z;      //!< z component of the fast force on each particle
+  vector<double> m_slow_x;      //!< x component of the slow force on each particle
+  vector<double> m_slow_y;      //!< y component of the slow force on each particle
+  vector<double> m_slow_z;      //!< z component of the slow force on each particle
+  
+  //! Parse fast/slow assignment of a force class
+  //! \param param Contains information about all parameters 
+  //! \param name name of the force class (pair, external, bond or angle)
+  //! \param def default assignment (true for fast)
+  bool is_fast(pairs_type& param, const string& name, bool def)
+  {
+    bool fast = def;
+    if (param.find(name) == param.end())
+      m_msg->msg(Messenger::WARNING,"RESPA integrator. Assuming that "+name+" forces are "+(def ? "fast" : "slow")+".");
+    else if (param[name] == "fast")
+      fast = true;
+    else if (param[name] == "slow")
+      fast = false;
+    else
+    {
+      m_msg->msg(Messenger::ERROR,"RESPA integrator. Force class "+name+" has to be either \"fast\" or \"slow\".");
+      throw runtime_error("Unknown RESPA force class assignment "+param[name]+".");
+    }
+    m_msg->msg(Messenger::INFO,"RESPA integrator. Treating "+name+" forces as "+(fast ? "fast" : "slow")+".");
+    m_msg->write_config("integrator.respa."+name,(fast ? "fast" : "slow"));
+    return fast;
+  }
+  
+  //! Compute fast forces and store them
+  void compute_fast();
+  
+  //! Compute slow forces and torques and store them
+  void compute_slow();
+  
+};
+
+typedef shared_ptr<IntegratorRESPA> IntegratorRESPAPtr;
+
+#endif
@@ -37,7 +37,7 @@
 void IntegratorSepulveda::integrate()
 {
   int N = m_system->get_group(m_group_name)->get_size();
-  vector<int> particles = m_system->get_group(m_group_name)->get_particles();
+  const vector<int>& particles = m_system->get_group(m_group_name)->get_particles();
   double dt_2 = 0.5*m_dt;
   double B = sqrt(m_tau*m_dt);
   double theta = 1.0 - m_dt;
@@ -64,9 +64,7 @@ void IntegratorSepulveda::integrate()
     int pi = particles[i];
     Particle& p = m_system->get_particle(pi);
     //Particle& p = m_system->get_particle(i);
-    p.x += m_dt*p.vx;
-    p.y += m_dt*p.vy;
-    p.z += m_dt*p.vz;
+    p.move(m_dt*p.vx, m_dt*p.vy, m_dt*p.vz);
     // Project everything back to the manifold
     m_constrainer->enforce(p);
   }
@@ -91,13 +91,13 @@ public:
     if (param.find("seed") == param.end())
     {
       m_msg->msg(Messenger::WARNING,"Sepulveda dynamics integrator for particle position. No random number generator seed specified. Using default 0.");
-      m_rng = make_shared<RNG>(0);
+      m_rng = make_shared<RNG>(0,"integrator_sepulveda");
       m_msg->write_config("integrator.Sepulveda.seed",lexical_cast<string>(0));
     }
     else
     {
       m_msg->msg(Messenger::INFO,"Sepulveda dynamics integrator for particle position. Setting random number generator seed to "+param["seed"]+".");
-      m_rng = make_shared<RNG>(lexical_cast<int>(param["seed"]));
+      m_rng = make_shared<RNG>(lexical_cast<int>(param["seed"]),"integrator_sepulveda");
       m_msg->write_config("integrator.Sepulveda.seed",param["seed"]);
     }
     if (param.find("sigma") == param.end())
@@ -139,6 +139,23 @@ public:
   //! Propagate system for a time step
   void integrate();
   
+  //! Save state of the random number generator and the current noise
+  //! \param ckp checkpoint writer
+  void write_checkpoint(CheckpointWriter& ckp) 
+  { 
+    m_rng->write_checkpoint(ckp); 
+    ckp.write_vector(m_eta_x);  ckp.write_vector(m_eta_y);  ckp.write_vector(m_eta_z);
+  }
+  
+  //! Restore state of the random number generator and the current noise
+  //! \param ckp checkpoint reader
+  void read_checkpoint(CheckpointReader& ckp) 
+  { 
+    if (!m_rng->read_checkpoint(ckp))
+      m_msg->msg(Messenger::WARNING,"Sepulveda dynamics integrator for particle position. Random number generator seed differs from the one in the checkpoint. Starting new random sequence.");
+    ckp.read_vector(m_eta_x);  ckp.read_vector(m_eta_y);  ckp.read_vector(m_eta_z);
+  }
+  
 private:
   
   RNGPtr  m_rng;             //!< Random number generator 
@@ -44,8 +44,9 @@
 void IntegratorVicsek::integrate()
 {
   double noise = m_eta*sqrt(m_dt);
+  int step = m_system->get_step();
   int N = m_system->get_group(m_group_name)->get_size();
-  vector<int> particles = m_system->get_group(m_group_name)->get_particles();
+  const vector<int>& particles = m_system->get_group(m_group_name)->get_particles();
   
   // reset forces and torques
   m_system->reset_forces();
@@ -69,12 +70,10 @@ void IntegratorVicsek::integrate()
     // Project everything back to the manifold
     m_constrainer->enforce(p);
     // Change orientation of the velocity (in the tangent plane) 
-    double theta = 2.0*noise*M_PI*(m_rng->drnd() - 0.5);
+    double theta = 2.0*noise*M_PI*(m_rng->drnd(p.get_flag(), step, 0) - 0.5);
     m_constrainer->rotate_velocity(p,theta);
     // Update particle position 
-    p.x += m_dt*p.vx;
-    p.y += m_dt*p.vy;
-    p.z += m_dt*p.vz;
+    p.move(m_dt*p.vx, m_dt*p.vy, m_dt*p.vz);
     // Project everything back to the manifold
     m_constrainer->enforce(p);
     p.age += m_dt;
@@ -96,6 +96,8 @@ public:
                  | qi::as_string[keyword["config"]][ phx::bind(&CommandData::command, phx::ref(command_data)) = qi::_1 ]          /*! Handles configuration file. */
                  | qi::as_string[keyword["pair_type_param"]][ phx::bind(&CommandData::command, phx::ref(command_data)) = qi::_1 ] /*! Handles particle type parameters for the pair potentials */
                  | qi::as_string[keyword["timestep"]][ phx::bind(&CommandData::command, phx::ref(command_data)) = qi::_1 ]        /*! Hangles global integrator step. */
+                 | qi::as_string[keyword["checkpoint"]][ phx::bind(&CommandData::command, phx::ref(command_data)) = qi::_1 ]      /*! Handles writing binary checkpoints. */
+                 | qi::as_string[keyword["restart"]][ phx::bind(&CommandData::command, phx::ref(command_data)) = qi::_1 ]         /*! Handles restarting from a binary checkpoint. */
                  /* to add new command: | qi::as_string[keyword["newcommand"]][ phx::bind(&CommandData::command, phx::ref(command_data)) = qi::_1 ] */
                )
                >> qi::as_string[qi::no_skip[+qi::char_]][phx::bind(&CommandData::attrib_param_complex, phx::ref(command_data)) = qi::_1 ]
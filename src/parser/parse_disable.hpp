@@ -62,6 +62,7 @@ public:
                   | qi::as_string[keyword["brownian"]][phx::bind(&DisableData::type, phx::ref(disable_data)) = qi::_1 ]    /*! Disables stochastic integrator */
                   | qi::as_string[keyword["vicsek"]][phx::bind(&DisableData::type, phx::ref(disable_data)) = qi::_1 ]      /*! Disables Vicsek integrator */
                   | qi::as_string[keyword["nematic"]][phx::bind(&DisableData::type, phx::ref(disable_data)) = qi::_1 ]     /*! Disables nematic integrator */
+                  | qi::as_string[keyword["brownian_implicit"]][phx::bind(&DisableData::type, phx::ref(disable_data)) = qi::_1 ]     /*! Disables brownian_implicit integrator */
                   | qi::as_string[keyword["brownian_pos"]][phx::bind(&DisableData::type, phx::ref(disable_data)) = qi::_1 ]     /*! Disables brownian_pos integrator */
                   | qi::as_string[keyword["brownian_rod"]][phx::bind(&DisableData::type, phx::ref(disable_data)) = qi::_1 ]     /*! Disables brownian_rod integrator */
                   /* to add new integrator: | qi::as_string[keyword["newintegrator"]][phx::bind(&DisableData::type, phx::ref(disable_data)) = qi::_1 ] */
@@ -68,11 +68,13 @@ public:
                   | qi::as_string[keyword["nematic"]][phx::bind(&IntegratorData::type, phx::ref(integrator_data)) = qi::_1 ]        /*! Handles nematic integrator */
                   | qi::as_string[keyword["actomyo"]][phx::bind(&IntegratorData::type, phx::ref(integrator_data)) = qi::_1 ]        /*! Handles actomyo integrator */
                   | qi::as_string[keyword["brownian_rod"]][phx::bind(&IntegratorData::type, phx::ref(integrator_data)) = qi::_1 ]   /*! Handles stochastic integrator for rods */
+                  | qi::as_string[keyword["brownian_implicit"]][phx::bind(&IntegratorData::type, phx::ref(integrator_data)) = qi::_1 ]  /*! Handles implicit stochastic integrator for particle position */
                   | qi::as_string[keyword["brownian_pos"]][phx::bind(&IntegratorData::type, phx::ref(integrator_data)) = qi::_1 ]   /*! Handles stochastic integrator for particle position */
                   | qi::as_string[keyword["brownian_align"]][phx::bind(&IntegratorData::type, phx::ref(integrator_data)) = qi::_1 ] /*! Handles stochastic integrator for particle alignment */
                   | qi::as_string[keyword["langevin"]][phx::bind(&IntegratorData::type, phx::ref(integrator_data)) = qi::_1 ]       /*! Handles Langevin stochastic integrator */
                   | qi::as_string[keyword["fire"]][phx::bind(&IntegratorData::type, phx::ref(integrator_data)) = qi::_1 ]           /*! Handles FIRE minimisation integrator */
                   | qi::as_string[keyword["sepulveda"]][phx::bind(&IntegratorData::type, phx::ref(integrator_data)) = qi::_1 ]      /*! Handles Sepulveda integrator */
+                  | qi::as_string[keyword["respa"]][phx::bind(&IntegratorData::type, phx::ref(integrator_data)) = qi::_1 ]          /*! Handles RESPA multiple time step integrator */
                   /* to add new integrator: | qi::as_string[keyword["newintegrator"]][phx::bind(&IntegratorData::type, phx::ref(integrator_data)) = qi::_1 ] */
                  )
                  >> qi::as_string[qi::no_skip[+qi::char_]][phx::bind(&IntegratorData::params, phx::ref(integrator_data)) = qi::_1 ]
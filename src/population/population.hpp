@@ -107,6 +107,13 @@ public:
   //! Change particle length
   virtual void elongate(int) = 0;
   
+  //! Save population state that is not set by the input script (e.g., random number generator)
+  //! \note By default, populations have no such state
+  virtual void write_checkpoint(CheckpointWriter&) { }
+  
+  //! Restore population state saved with write_checkpoint
+  virtual void read_checkpoint(CheckpointReader&) { }
+  
 protected:
   
   SystemPtr m_system;            //!< Contains pointer to the System object
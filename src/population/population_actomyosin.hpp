@@ -61,13 +61,13 @@ public:
     if (param.find("seed") == param.end())
     {
       m_msg->msg(Messenger::WARNING,"Actomyosin population control. No random number generator seed specified. Using default 0.");
-      m_rng = make_shared<RNG>(0);
+      m_rng = make_shared<RNG>(0,"population_actomyosin");
       m_msg->write_config("population.actomyosin.seed",lexical_cast<string>(0));
     }
     else
     {
       m_msg->msg(Messenger::INFO,"Actomyosin population control. Setting random number generator seed to "+param["seed"]+".");
-      m_rng = make_shared<RNG>(lexical_cast<int>(param["seed"]));
+      m_rng = make_shared<RNG>(lexical_cast<int>(param["seed"]),"population_actomyosin");
       m_msg->write_config("population.actomyosin.seed",param["seed"]);
     }
     
@@ -175,6 +175,18 @@ public:
   //! Not used here
   void elongate(int time) { }
   
+  //! Save state of the random number generator
+  //! \param ckp checkpoint writer
+  void write_checkpoint(CheckpointWriter& ckp) { m_rng->write_checkpoint(ckp); }
+  
+  //! Restore state of the random number generator
+  //! \param ckp checkpoint reader
+  void read_checkpoint(CheckpointReader& ckp) 
+  { 
+    if (!m_rng->read_checkpoint(ckp))
+      m_msg->msg(Messenger::WARNING,"Actomyosin population control. Random number generator seed differs from the one in the checkpoint. Starting new random sequence.");
+  }
+  
   
 private:
   
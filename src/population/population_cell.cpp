@@ -86,7 +86,7 @@ void PopulationCell::divide(int t)
     double fact = m_freq*m_div_rate*m_system->get_integrator_step();
     Mesh& mesh = m_system->get_mesh();
     int N = m_system->get_group(m_group_name)->get_size();
-    vector<int> particles = m_system->get_group(m_group_name)->get_particles();
+    const vector<int>& particles = m_system->get_group(m_group_name)->get_particles();
     for (int i = 0; i < N; i++)
     {
       int pi = particles[i];
@@ -97,7 +97,7 @@ void PopulationCell::divide(int t)
       if (p.in_tissue && !p.boundary && V.area > m_max_A0)
       { 
         double prob_div = fact*(V.area - m_max_A0); // Bell model of division
-        if (m_rng->drnd() < prob_div)  // Only internal verices can divide
+        if (m_rng->drnd(p.get_flag(), t, 0) < prob_div)  // Only internal verices can divide
         {
           //cout << t << " " << V.area << " " << p.A0 << " " << exp((V.area-p.A0)/m_div_rate) << endl;
           Particle p_new(m_system->size(), p.get_type(), p.get_radius());
@@ -125,10 +125,12 @@ void PopulationCell::divide(int t)
           p_new.in_tissue = true;
           for(list<string>::iterator it_g = p.groups.begin(); it_g != p.groups.end(); it_g++)
             p_new.add_group(*it_g);
-          m_system->add_particle(p_new);
+          m_system->stage_particle(p_new);
         }
       }
     }
+    // Add all new cells at once 
+    m_system->commit_particles();
     if (!m_system->group_ok(m_group_name))
     {
       cout << "After cell division: Group info mismatch for group : " << m_group_name << endl;
@@ -157,7 +159,7 @@ void PopulationCell::remove(int t)
       throw runtime_error("Group mismatch.");
     }
     int N = m_system->get_group(m_group_name)->get_size();
-    vector<int> particles = m_system->get_group(m_group_name)->get_particles();
+    const vector<int>& particles = m_system->get_group(m_group_name)->get_particles();
     vector<int> to_remove;
     for (int i = 0; i < N; i++)
     {
@@ -170,15 +172,10 @@ void PopulationCell::remove(int t)
       // Trying a very simple, linearly increasing death chance
       //double prob_death = fact*p.age/m_max_age;
       double prob_death = m_death_rate*m_freq*m_system->get_integrator_step(); // actual probability of dividing now: rate * (attempt_freq * dt)
-      if (p.in_tissue && !p.boundary && m_rng->drnd() < prob_death)
+      if (p.in_tissue && !p.boundary && m_rng->drnd(p.get_flag(), t, 4) < prob_death)
           to_remove.push_back(p.get_id());
     }
-    int offset = 0;
-    for (vector<int>::iterator it = to_remove.begin(); it != to_remove.end(); it++)
-    {
-      m_system->remove_particle((*it)-offset);
-      offset++;      
-    }
+    m_system->remove_particles(to_remove);
     if (m_system->size() == 0)
     {
       m_msg->msg(Messenger::ERROR,"Cell population control. No cells left in the system. Please reduce that death rate.");
@@ -204,14 +201,14 @@ void PopulationCell::grow(int t)
   { 
     double fact = m_freq*m_system->get_integrator_step()*m_growth_rate;
     int N = m_system->get_group(m_group_name)->get_size();
-    vector<int> particles = m_system->get_group(m_group_name)->get_particles();
+    const vector<int>& particles = m_system->get_group(m_group_name)->get_particles();
     for (int i = 0; i < N; i++)
     {
 	  // Growth probability stays dimensionless, between 0 and 1. Instead, the actual growth rate is no an inverse time
-      if (m_rng->drnd() < m_growth_prob)
+      int pi = particles[i];
+      Particle& p = m_system->get_particle(pi); 
+      if (m_rng->drnd(p.get_flag(), t, 5) < m_growth_prob)
       {
-        int pi = particles[i];
-        Particle& p = m_system->get_particle(pi); 
         if (p.in_tissue)
           p.A0 *= (1.0+fact);
       }
@@ -68,7 +68,7 @@ void PopulationDensity::divide(int t)
     {
       int pi = particles[i];
       Particle& p = m_system->get_particle(pi); 
-      if (m_rng->drnd() < prob_div*(1.0-p.coordination/m_rho_max))
+      if (m_rng->drnd(p.get_flag(), t, 0) < prob_div*(1.0-p.coordination/m_rho_max))
       {
         Particle p_new(m_system->size(), p.get_type(), p.get_radius());
         p_new.x = p.x + m_alpha*m_split_distance*p.get_radius()*p.nx;
@@ -94,7 +94,7 @@ void PopulationDensity::divide(int t)
         p_new.set_length(p.get_length());
         p_new.set_default_area(p.get_A0());
         p_new.A0 = p.A0;
-        if (m_rng->drnd() < m_type_change_prob_1)  // Attempt to change type and group for first child
+        if (m_rng->drnd(p.get_flag(), t, 1) < m_type_change_prob_1)  // Attempt to change type and group for first child
         {
           if (m_new_type == 0)
             new_type = p.get_type();
@@ -111,29 +111,30 @@ void PopulationDensity::divide(int t)
           if (m_poly == 0.0)
             new_r = m_new_radius;
           else 
-            new_r = m_new_radius*(1.0 + m_poly*(m_rng->drnd() - 0.5));
+            new_r = m_new_radius*(1.0 + m_poly*(m_rng->drnd(p.get_flag(), t, 2) - 0.5));
         }
         p_new.set_radius(new_r);
-        if (m_rng->drnd() < m_type_change_prob_2)  // Attempt to change type and group for second child
+        if (m_rng->drnd(p.get_flag(), t, 3) < m_type_change_prob_2)  // Attempt to change type and group for second child
         {
           if (m_new_type == 0)
             new_type = p_new.get_type();
           else
             new_type = m_new_type;
           p_new.set_type(new_type);
-          m_system->add_particle(p_new);
-          m_system->change_group(p_new.get_id(),m_old_group,m_new_group);
+          if (m_old_group != "all")  // Particle always stays in "all"
+            p_new.groups.remove(m_old_group);
+          p_new.add_group(m_new_group);
         }
-        else
-          m_system->add_particle(p_new); 
+        m_system->stage_particle(p_new); 
       }
     }
+    // Add all new particles at once (this also flags the neighbour list for update)
+    m_system->commit_particles();
     if (!m_system->group_ok(m_group_name))
     {
       cout << "After Divide P: Group info mismatch for group : " << m_group_name << endl;
       throw runtime_error("Group mismatch.");
     }
-    m_system->set_force_nlist_rebuild(true);
   }
 }
 
@@ -155,7 +156,7 @@ void PopulationDensity::remove(int t)
       throw runtime_error("Group mismatch.");
     }
     int N = m_system->get_group(m_group_name)->get_size();
-    vector<int> particles = m_system->get_group(m_group_name)->get_particles();
+    const vector<int>& particles = m_system->get_group(m_group_name)->get_particles();
     vector<int> to_remove;
     double prob_death = m_death_rate*m_freq*m_system->get_integrator_step(); // actual probability of dividing now: rate * (attempt_freq * dt)
     if (prob_death>1.0)
@@ -167,15 +168,10 @@ void PopulationDensity::remove(int t)
     {
       int pi = particles[i];
       Particle& p = m_system->get_particle(pi);
-      if (m_rng->drnd() < prob_death)
+      if (m_rng->drnd(p.get_flag(), t, 4) < prob_death)
         to_remove.push_back(p.get_id());
     }
-    int offset = 0;
-    for (vector<int>::iterator it = to_remove.begin(); it != to_remove.end(); it++)
-    {
-      m_system->remove_particle((*it)-offset);
-      offset++;      
-    }
+    m_system->remove_particles(to_remove);
     if (m_system->size() == 0)
     {
       m_msg->msg(Messenger::ERROR,"Density population control. No particles left in the system. Please reduce that death rate.");
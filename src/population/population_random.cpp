@@ -63,7 +63,7 @@ void PopulationRandom::divide(int t)
     {
       int pi = particles[i];
       Particle& p = m_system->get_particle(pi);
-      if (m_rng->drnd() < p.age*prob_div)
+      if (m_rng->drnd(p.get_flag(), t, 0) < p.age*prob_div)
       {
         Particle p_new(m_system->size(), p.get_type(), p.get_radius());
         p_new.x = p.x + m_alpha*p.get_radius()*p.nx;
@@ -97,7 +97,7 @@ void PopulationRandom::divide(int t)
         p_new.age = 0.0;
         for(list<string>::iterator it_g = p.groups.begin(); it_g != p.groups.end(); it_g++)
           p_new.add_group(*it_g);
-        if (m_rng->drnd() < m_type_change_prob_1)  // Attempt to change type, radius and group for first child
+        if (m_rng->drnd(p.get_flag(), t, 1) < m_type_change_prob_1)  // Attempt to change type, radius and group for first child
         {
           if (m_new_type == 0)
             new_type = p.get_type();
@@ -111,9 +111,10 @@ void PopulationRandom::divide(int t)
           p.set_radius(new_r);
           m_system->change_group(p.get_id(),m_old_group,m_new_group);
         }
+        int parent_flag = p.get_flag();  // p may be invalidated by add_particle
         m_system->add_particle(p_new);
         Particle& pr = m_system->get_particle(p_new.get_id());
-        if (m_rng->drnd() < m_type_change_prob_2)  // Attempt to change type, radius and group for second child
+        if (m_rng->drnd(parent_flag, t, 3) < m_type_change_prob_2)  // Attempt to change type, radius and group for second child
         {
           if (m_new_type == 0)
             new_type = pr.get_type();
@@ -146,7 +147,7 @@ void PopulationRandom::remove(int t)
   if (m_freq > 0 && t % m_freq == 0)  // Attempt removal only at certain time steps
   { 
     int N = m_system->get_group(m_group_name)->get_size();
-    vector<int> particles = m_system->get_group(m_group_name)->get_particles();
+    const vector<int>& particles = m_system->get_group(m_group_name)->get_particles();
     vector<int> to_remove;
     double prob_death = m_death_rate*m_freq*m_system->get_integrator_step(); // actual probability of dividing now: rate * (attempt_freq * dt)
     if (prob_death>1.0)
@@ -158,15 +159,10 @@ void PopulationRandom::remove(int t)
     {
       int pi = particles[i];
       Particle& p = m_system->get_particle(pi);
-      if (m_rng->drnd() < p.age*prob_death)
+      if (m_rng->drnd(p.get_flag(), t, 4) < p.age*prob_death)
         to_remove.push_back(p.get_id());
     }
-    int offset = 0;
-    for (vector<int>::iterator it = to_remove.begin(); it != to_remove.end(); it++)
-    {
-      m_system->remove_particle((*it)-offset);
-      offset++;      
-    }
+    m_system->remove_particles(to_remove);
     if (m_system->size() == 0)
     {
       m_msg->msg(Messenger::ERROR,"Random population control. No particles left in the system. Please reduce that death rate.");
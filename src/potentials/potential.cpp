@@ -36,18 +36,47 @@
 void Potential::compute(double dt)
 {
   //m_system->reset_forces();
-  PairPotType::iterator it_pair;
-  ExternPotType::iterator it_ext;
-  BondPotType::iterator it_bond;
-  AnglePotType::iterator it_angle;
-  
-  for(it_pair = m_pair_interactions.begin(); it_pair != m_pair_interactions.end(); it_pair++)
+  this->compute_pair(dt);
+  this->compute_external();
+  this->compute_bond();
+  this->compute_angle();
+}
+
+/*! Iterate over all pair potentials and compute 
+ *  potential energies and forces. Used by multiple time step integrators
+ *  that evaluate different classes of forces at different rates.
+ *  \param dt step size (used to phase in particles)
+ */
+void Potential::compute_pair(double dt)
+{
+  for(PairPotType::iterator it_pair = m_pair_interactions.begin(); it_pair != m_pair_interactions.end(); it_pair++)
     (*it_pair).second->compute(dt);
-  for(it_ext = m_external_potentials.begin(); it_ext != m_external_potentials.end(); it_ext++)
+}
+
+/*! Iterate over all external potentials and compute 
+ *  potential energies and forces.
+ */
+void Potential::compute_external()
+{
+  for(ExternPotType::iterator it_ext = m_external_potentials.begin(); it_ext != m_external_potentials.end(); it_ext++)
     (*it_ext).second->compute();
-  for(it_bond = m_bond.begin(); it_bond != m_bond.end(); it_bond++)
+}
+
+/*! Iterate over all bond potentials and compute 
+ *  potential energies and forces.
+ */
+void Potential::compute_bond()
+{
+  for(BondPotType::iterator it_bond = m_bond.begin(); it_bond != m_bond.end(); it_bond++)
     (*it_bond).second->compute();
-  for(it_angle = m_angle.begin(); it_angle != m_angle.end(); it_angle++)
+}
+
+/*! Iterate over all angle potentials and compute 
+ *  potential energies and forces.
+ */
+void Potential::compute_angle()
+{
+  for(AnglePotType::iterator it_angle = m_angle.begin(); it_angle != m_angle.end(); it_angle++)
     (*it_angle).second->compute();
 }
 
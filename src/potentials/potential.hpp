@@ -210,6 +210,18 @@ public:
   //! Compute all forces and potentials in the system
   void compute(double);
   
+  //! Compute forces and potentials due to pair interactions only
+  void compute_pair(double);
+  
+  //! Compute forces and potentials due to external potentials only
+  void compute_external();
+  
+  //! Compute forces and potentials due to bonds only
+  void compute_bond();
+  
+  //! Compute forces and potentials due to angles only
+  void compute_angle();
+  
 private:
   
   SystemPtr m_system;            //!< Contains pointer to the System object
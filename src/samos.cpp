@@ -37,6 +37,7 @@
 #include <boost/function.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/make_shared.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
 
 #include "samos.hpp"
 
@@ -44,6 +45,35 @@
 #include "register.hpp"
 
 
+/*! Collect the entire state of the simulation into a checkpoint. Sections 
+ *  "run" (cumulative time step) and "system" are followed by one section per integrator 
+ *  ("integrator.<type>_<group>") and one per population ("population.<index>").
+ *  \param ckp checkpoint writer
+ *  \param sys pointer to the System object
+ *  \param integrator all integrators 
+ *  \param population all populations
+ *  \param time_step current cumulative time step
+ */
+static void fill_checkpoint(CheckpointWriter& ckp, SystemPtr sys, std::map<std::string,IntegratorPtr>& integrator, vector<PopulationPtr>& population, int time_step)
+{
+  ckp.begin_section("run");
+  ckp.write(time_step);
+  ckp.end_section();
+  sys->write_checkpoint(ckp);
+  for (std::map<std::string, IntegratorPtr>::iterator it_integ = integrator.begin(); it_integ != integrator.end(); it_integ++)
+  {
+    ckp.begin_section("integrator."+(*it_integ).first);
+    (*it_integ).second->write_checkpoint(ckp);
+    ckp.end_section();
+  }
+  for (unsigned int i = 0; i < population.size(); i++)
+  {
+    ckp.begin_section("population."+lexical_cast<string>(i));
+    population[i]->write_checkpoint(ckp);
+    ckp.end_section();
+  }
+}
+
 int main(int argc, char* argv[])
 {
   // Parser data
@@ -113,6 +143,8 @@ int main(int argc, char* argv[])
   vector<DumpPtr> dump;                            // Handles all different dumps
   vector<LoggerPtr> log;                           // Handles all different logs
   vector<PopulationPtr>  population;               // Handles all population methods
+  CheckpointReaderPtr restart_state;               // Checkpoint the simulation was restarted from (holds integrator and population states)
+  PeriodicCheckpointPtr periodic_checkpoint;       // Handles periodic checkpoints written during runs
   
   bool periodic = false;        // If true, use periodic boundary conditions
   bool has_potential = false;   // If false, potential handling object (Potential class) has not be initialized yet
@@ -256,6 +288,73 @@ int main(int argc, char* argv[])
               throw std::runtime_error("Could not parse input command.");
             }
           }
+          else if (command_data.command == "restart")       // if command is restart, read in the entire system from a binary checkpoint (replaces input)
+          {
+            if (qi::phrase_parse(command_data.attrib_param_complex.begin(), command_data.attrib_param_complex.end(), input_parser, qi::space))  
+            {
+              if (!defined["messages"])  // If messenger is not defined, send to default messenger defined at the top of this file
+              {
+                string msg_name = DEFAULT_MESSENGER;
+                msg = boost::shared_ptr<Messenger>(new Messenger(msg_name));
+                msg->msg(Messenger::WARNING,"Messenger was not defined prior to the reading in data. If not redefined all messages will be sent to "+msg_name+".");
+              }
+              if (!defined["box"])   // Box is overwritten by the stored one, but periodicity comes from the box command
+              {
+                msg->msg(Messenger::ERROR,"Simulation box has not been defined. Please define it before restarting from a checkpoint.");
+                throw std::runtime_error("Simulation box not defined.");
+              }
+              if (defined["input"])
+              {
+                msg->msg(Messenger::ERROR,"System has already been defined. Command \"restart\" replaces \"input\" command.");
+                throw std::runtime_error("System already defined.");
+              }
+              restart_state = boost::make_shared<CheckpointReader>(input_data.name);
+              sys = SystemPtr(new System(*restart_state,msg,box));
+              sys->set_periodic(periodic);
+              restart_state->open_section("run");
+              restart_state->read(time_step);
+              defined["input"] = true;
+              if (sys->num_bonds() > 0)  defined["read_bonds"] = true;
+              if (sys->num_angles() > 0) defined["read_angles"] = true;
+              msg->msg(Messenger::INFO,"Restarting from checkpoint "+input_data.name+" at time step "+lexical_cast<string>(time_step)+".");
+            }
+            else
+            {
+              std::cerr << "Could not parse restart command." << std::endl;
+              throw std::runtime_error("Could not parse restart command.");
+            }
+          }
+          else if (command_data.command == "checkpoint")       // if command is checkpoint, write the entire simulation state into a binary file
+          {
+            if (!defined["input"])  // We need to have system defined before we can save it
+            {
+              if (defined["messages"])
+                msg->msg(Messenger::ERROR,"System has not been defined. Please define system using \"input\" command before writing a checkpoint.");
+              else
+                std::cerr << "System has not been defined. Please define system using \"input\" command before writing a checkpoint." << std::endl;
+              throw std::runtime_error("System not defined.");
+            }
+            if (qi::phrase_parse(command_data.attrib_param_complex.begin(), command_data.attrib_param_complex.end(), log_dump_parser, qi::space) &&
+                qi::phrase_parse(log_dump_data.params.begin(), log_dump_data.params.end(), param_parser, qi::space, parameter_data) && 
+                parameter_data.find("freq") != parameter_data.end())
+            {
+              if (periodic_checkpoint)
+                periodic_checkpoint->finish();
+              periodic_checkpoint = PeriodicCheckpointPtr(new PeriodicCheckpoint(msg,log_dump_data.name,parameter_data,time_step));
+            }
+            else if (qi::phrase_parse(command_data.attrib_param_complex.begin(), command_data.attrib_param_complex.end(), input_parser, qi::space))  
+            {
+              CheckpointWriter ckp;
+              fill_checkpoint(ckp, sys, integrator, population, time_step);
+              ckp.save(input_data.name);
+              msg->msg(Messenger::INFO,"Wrote checkpoint "+input_data.name+" ("+lexical_cast<string>(ckp.size())+" bytes) at time step "+lexical_cast<string>(time_step)+".");
+            }
+            else
+            {
+              std::cerr << "Could not parse checkpoint command." << std::endl;
+              throw std::runtime_error("Could not parse checkpoint command.");
+            }
+          }
           else if (command_data.command == "read_bonds")       // if command is read_bonds, parse it and read in the bonds information, if possible
           {
             if (qi::phrase_parse(command_data.attrib_param_complex.begin(), command_data.attrib_param_complex.end(), input_parser, qi::space))  
@@ -672,6 +771,12 @@ int main(int argc, char* argv[])
                                                                                                   )
                                                                                                  );
                   msg->msg(Messenger::INFO,"Adding integrator of type "+integrator_data.type+".");
+                  if (restart_state && restart_state->has_section("integrator."+integrator_data.type+"_"+group_name))
+                  {
+                    restart_state->open_section("integrator."+integrator_data.type+"_"+group_name);
+                    integrator[integrator_data.type+"_"+group_name]->read_checkpoint(*restart_state);
+                    msg->msg(Messenger::INFO,"Restored state of integrator "+integrator_data.type+"_"+group_name+" from checkpoint "+restart_state->get_name()+".");
+                  }
                 }
                 else
                 {
@@ -868,17 +973,36 @@ int main(int argc, char* argv[])
               {
                 sys->set_step(time_step);
                 sys->set_run_step(t);
-                if (constraint->rescale())
+                if (periodic_checkpoint && periodic_checkpoint->due(time_step))
                 {
-                  nlist->build();
-                  nlist_builds++;
+                  boost::posix_time::ptime snapshot_start = boost::posix_time::microsec_clock::universal_time();
+                  boost::shared_ptr<CheckpointWriter> ckp = boost::make_shared<CheckpointWriter>();
+                  fill_checkpoint(*ckp, sys, integrator, population, time_step);
+                  double snapshot_time = (boost::posix_time::microsec_clock::universal_time() - snapshot_start).total_microseconds()*1e-6;
+                  periodic_checkpoint->submit(ckp, time_step, snapshot_time);
+                }
+                bool affine;
+                double sx, sy, sz;
+                if (constraint->rescale(affine,sx,sy,sz))
+                {
+                  if (!affine)
+                  {
+                    nlist->build();
+                    nlist_builds++;
+                  }
+                  else if (nlist->affine_rescale(sx,sy,sz))
+                    nlist_builds++;
                 }
                 for (vector<DumpPtr>::iterator it_d = dump.begin(); it_d != dump.end(); it_d++)
                   (*it_d)->dump(time_step);
 				        for (vector<LoggerPtr>::iterator it_l = log.begin(); it_l != log.end(); it_l++)
                   (*it_l)->log();
+                bool converged = true;    // run ends early only once all integrators have converged (e.g. FIRE minimisation)
                 for (std::map<std::string, IntegratorPtr>::iterator it_integ = integrator.begin(); it_integ != integrator.end(); it_integ++)
+                {
                   (*it_integ).second->integrate();
+                  converged = converged && (*it_integ).second->converged();
+                }
                 if (has_population)
                 {
                   for (vector<PopulationPtr>::iterator it_pop = population.begin(); it_pop != population.end(); it_pop++)
@@ -886,9 +1010,15 @@ int main(int argc, char* argv[])
                     (*it_pop)->divide(time_step);
                     if (sys->get_force_nlist_rebuild() && ((pot && pot->need_nlist()) || (aligner && aligner->need_nlist())))
                     {
-                      nlist->build();
-                      nlist_builds++;
+                      if (sys->get_nlist_append() >= 0)
+                        nlist->add_particles(sys->get_nlist_append());
+                      else
+                      {
+                        nlist->build();
+                        nlist_builds++;
+                      }
                       sys->set_force_nlist_rebuild(false);
+                      sys->set_nlist_append(-1);
                     }
                     (*it_pop)->remove(time_step);
                     if (sys->get_force_nlist_rebuild() && ((pot && pot->need_nlist()) || (aligner && aligner->need_nlist())))
@@ -948,7 +1078,16 @@ int main(int argc, char* argv[])
                 if (t % PRINT_EVERY == 0)
                   std::cout << "Time step: " << t <<"/" << run_data.steps << "   cumulative time step : " << time_step<< std::endl;
                 time_step++;
+                if (converged)
+                {
+                  msg->msg(Messenger::INFO,"Integrator converged after "+lexical_cast<string>(t+1)+" steps. Ending run.");
+                  break;
+                }
               }
+              if (periodic_checkpoint)
+                periodic_checkpoint->finish();
+              for (vector<DumpPtr>::iterator it_d = dump.begin(); it_d != dump.end(); it_d++)
+                (*it_d)->finish();
               msg->msg(Messenger::INFO,"Built neighbour list "+lexical_cast<string>(nlist_builds)+" time. Average number of steps between two builds : "+lexical_cast<string>(static_cast<double>(run_data.steps)/nlist_builds)+".");
             }
             else
@@ -1219,6 +1358,13 @@ int main(int argc, char* argv[])
                 if (defined["nlist"])
                   population[population.size()-1]->set_nlist(nlist);
                 msg->msg(Messenger::INFO,"Adding population of type "+population_data.type+".");
+                string population_section = "population."+lexical_cast<string>(population.size()-1);
+                if (restart_state && restart_state->has_section(population_section))
+                {
+                  restart_state->open_section(population_section);
+                  population[population.size()-1]->read_checkpoint(*restart_state);
+                  msg->msg(Messenger::INFO,"Restored state of population "+population_data.type+" from checkpoint "+restart_state->get_name()+".");
+                }
                 has_population = true;
               }
               else
@@ -33,6 +33,7 @@
 #include "defaults.hpp"
 #include "messenger.hpp"
 #include "dump.hpp"
+#include "periodic_checkpoint.hpp"
 #include "logger.hpp"
 #include "parse_command.hpp"
 #include "parse_constraint.hpp"
@@ -106,10 +107,12 @@
 #include "integrator_nematic.hpp"
 #include "integrator_actomyo.hpp"
 #include "integrator_brownian_pos.hpp"
+#include "integrator_brownian_implicit.hpp"
 #include "integrator_brownian_align.hpp"
 #include "integrator_langevin.hpp"
 #include "integrator_fire.hpp"
 #include "integrator_sepulveda.hpp"
+#include "integrator_respa.hpp"
 #include "aligner.hpp"
 #include "pair_aligner.hpp"
 #include "pair_polar_aligner.hpp"
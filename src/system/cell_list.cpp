@@ -91,12 +91,12 @@ void CellList::populate()
     Particle& p = m_system->get_particle(i);
     if (periodic)
     {
-      if (p.x < box->xlo) p.x += lx;
-      else if (p.x > box->xhi) p.x -= lx;
-      if (p.y < box->ylo) p.y += ly;
-      else if (p.y > box->yhi) p.y -= ly;
-      if (p.z < box->zlo) p.z += lz;
-      else if (p.z > box->zhi) p.z -= lz;
+      if (p.x < box->xlo) p.move(lx, 0.0, 0.0);
+      else if (p.x > box->xhi) p.move(-lx, 0.0, 0.0);
+      if (p.y < box->ylo) p.move(0.0, ly, 0.0);
+      else if (p.y > box->yhi) p.move(0.0, -ly, 0.0);
+      if (p.z < box->zlo) p.move(0.0, 0.0, lz);
+      else if (p.z > box->zhi) p.move(0.0, 0.0, -lz);
     }
     this->add_particle(p);
   }
@@ -69,6 +69,18 @@ public:
   //! Populates cell list
   void populate();
   
+  //! Update cell widths to follow changes of the box size (e.g., after affine rescaling)
+  //! \param cutoff smallest allowed cell width
+  //! \return false if cells became smaller than the cutoff and cell list needs to be rebuilt
+  bool update_geometry(double cutoff)
+  {
+    BoxPtr box = m_system->get_box();
+    m_wx = box->Lx/m_nx;
+    m_wy = box->Ly/m_ny;
+    m_wz = box->Lz/m_nz;
+    return (m_wx >= cutoff && m_wy >= cutoff && m_wz >= cutoff);
+  }
+  
 private:
   
   SystemPtr m_system;              //!< Pointer to the System object
@@ -0,0 +1,171 @@
+/* ***************************************************************************
+ *
+ *  Copyright (C) 2013-2016 University of Dundee
+ *  All rights reserved. 
+ *
+ *  This file is part of SAMoS (Soft Active Matter on Surfaces) program.
+ *
+ *  SAMoS is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  SAMoS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ****************************************************************************/
+
+/*!
+ * \file checkpoint.cpp
+ * \author Rastko Sknepnek, sknepnek@gmail.com
+ * \date 18-Oct-2026
+ * \brief Implementation of CheckpointWriter and CheckpointReader class members.
+ */ 
+
+#include "checkpoint.hpp"
+
+#include <cerrno>
+#include <cstdio>
+
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+//! Construct the writer and write the header
+CheckpointWriter::CheckpointWriter() : m_section_start(0), m_in_section(false)
+{
+  m_data.insert(m_data.end(), CHECKPOINT_MAGIC, CHECKPOINT_MAGIC + sizeof(CHECKPOINT_MAGIC));
+  this->write(CHECKPOINT_VERSION);
+  this->write(CHECKPOINT_BYTE_ORDER);
+}
+
+/*! Start a new section. Payload size is filled in by end_section().
+ *  \param name section name
+ */
+void CheckpointWriter::begin_section(const string& name)
+{
+  if (m_in_section)
+    this->end_section();
+  this->write_string(name);
+  m_section_start = m_data.size();
+  this->write<boost::uint64_t>(0);
+  m_in_section = true;
+}
+
+//! Finish current section by recording the size of its payload
+void CheckpointWriter::end_section()
+{
+  if (!m_in_section) return;
+  boost::uint64_t len = m_data.size() - m_section_start - sizeof(boost::uint64_t);
+  memcpy(&m_data[m_section_start], &len, sizeof(len));
+  m_in_section = false;
+}
+
+/*! Write a string preceded by its length
+ *  \param s string to write
+ */
+void CheckpointWriter::write_string(const string& s)
+{
+  this->write<boost::uint32_t>(s.size());
+  m_data.insert(m_data.end(), s.begin(), s.end());
+}
+
+/*! Write checkpoint to disk. Data is written into name.tmp, flushed to 
+ *  the disk and then renamed to name. Rename is atomic, so name always 
+ *  refers either to the old or to the new complete checkpoint.
+ *  \param name file name
+ */
+void CheckpointWriter::save(const string& name) const
+{
+  if (m_in_section)
+    throw runtime_error("Checkpoint section has not been finished.");
+  string tmp_name = name + ".tmp";
+  int fd = open(tmp_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+    throw runtime_error("Problem opening checkpoint file "+tmp_name+" for writing.");
+  size_t done = 0;
+  while (done < m_data.size())
+  {
+    ssize_t n = ::write(fd, &m_data[done], m_data.size() - done);
+    if (n < 0)
+    {
+      if (errno == EINTR) continue;
+      close(fd);
+      throw runtime_error("Problem writing checkpoint file "+tmp_name+".");
+    }
+    done += n;
+  }
+  if (fsync(fd) != 0 || close(fd) != 0)
+    throw runtime_error("Problem writing checkpoint file "+tmp_name+".");
+  if (rename(tmp_name.c_str(), name.c_str()) != 0)
+    throw runtime_error("Problem renaming checkpoint file "+tmp_name+" to "+name+".");
+  // Make the rename itself durable
+  size_t slash = name.rfind('/');
+  string dir_name = (slash == string::npos) ? "." : name.substr(0, slash+1);
+  int dir_fd = open(dir_name.c_str(), O_RDONLY);
+  if (dir_fd >= 0)
+  {
+    fsync(dir_fd);
+    close(dir_fd);
+  }
+}
+
+/*! Open checkpoint file, check the header and index all sections
+ *  \param name file name
+ */
+CheckpointReader::CheckpointReader(const string& name) : m_name(name), m_data(0), m_pos(0), m_end(0), m_version(0)
+{
+  m_file = shared_ptr<MappedFile>(new MappedFile(name));
+  m_data = m_file->data();
+  m_end = m_file->size();
+  if (m_end < sizeof(CHECKPOINT_MAGIC) || memcmp(m_data, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC)) != 0)
+    throw runtime_error("File "+name+" is not a checkpoint file.");
+  m_pos = sizeof(CHECKPOINT_MAGIC);
+  boost::uint32_t byte_order;
+  this->read(m_version);
+  this->read(byte_order);
+  if (byte_order != CHECKPOINT_BYTE_ORDER)
+    throw runtime_error("Checkpoint file "+name+" has been written on a machine with different byte order.");
+  if (m_version > CHECKPOINT_VERSION)
+    throw runtime_error("Checkpoint file "+name+" has been written by a newer version of the code.");
+  while (m_pos < m_end)
+  {
+    string section;
+    boost::uint64_t len;
+    this->read_string(section);
+    this->read(len);
+    if (len > m_end - m_pos)
+      throw runtime_error("Corrupted checkpoint file "+name+".");
+    m_sections[section] = std::make_pair(m_pos, m_pos + len);
+    m_pos += len;
+  }
+}
+
+/*! Position reader at the beginning of a section
+ *  \param name section name
+ */
+void CheckpointReader::open_section(const string& name)
+{
+  map<string, pair<size_t,size_t> >::iterator it = m_sections.find(name);
+  if (it == m_sections.end())
+    throw runtime_error("Checkpoint file "+m_name+" does not contain section "+name+".");
+  m_pos = (*it).second.first;
+  m_end = (*it).second.second;
+}
+
+/*! Read a string written with write_string
+ *  \param s on return, the string
+ */
+void CheckpointReader::read_string(string& s)
+{
+  boost::uint32_t len;
+  this->read(len);
+  this->check(len);
+  s.assign(m_data + m_pos, len);
+  m_pos += len;
+}
@@ -0,0 +1,191 @@
+/* ***************************************************************************
+ *
+ *  Copyright (C) 2013-2016 University of Dundee
+ *  All rights reserved. 
+ *
+ *  This file is part of SAMoS (Soft Active Matter on Surfaces) program.
+ *
+ *  SAMoS is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  SAMoS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ****************************************************************************/
+
+/*!
+ * \file checkpoint.hpp
+ * \author Rastko Sknepnek, sknepnek@gmail.com
+ * \date 18-Oct-2026
+ * \brief Declaration of CheckpointWriter and CheckpointReader classes (native binary restart files).
+ */ 
+
+#ifndef __CHECKPOINT_HPP__
+#define __CHECKPOINT_HPP__
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstring>
+#include <stdexcept>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/cstdint.hpp>
+
+#include "mapped_file.hpp"
+
+using std::string;
+using std::vector;
+using std::map;
+using std::pair;
+using std::runtime_error;
+
+using boost::shared_ptr;
+
+const char CHECKPOINT_MAGIC[8] = { 'S', 'A', 'M', 'O', 'S', 'C', 'K', 'P' };  //!< First eight bytes of every checkpoint file
+const boost::uint32_t CHECKPOINT_VERSION = 1;                                  //!< Current version of the checkpoint format
+const boost::uint32_t CHECKPOINT_BYTE_ORDER = 0x01020304;                      //!< Used to detect files written on machines with different endianness
+
+/*! Builds a checkpoint in memory and writes it to disk. 
+ *
+ *  Checkpoint file consists of a header (magic string, format version and 
+ *  byte order mark) followed by a sequence of named sections (e.g., "system" or 
+ *  "integrator.fire_all"). Each section stores its name and the size of its payload, 
+ *  so readers can locate sections directly and skip the ones they do not know about. 
+ *  All data is stored in the native binary representation. 
+ *
+ *  File is first written into a temporary file which is then renamed, so a crash 
+ *  while writing never leaves a truncated checkpoint behind.
+ */
+class CheckpointWriter
+{
+public:
+  
+  //! Construct the writer and write the header
+  CheckpointWriter();
+  
+  //! Start a new section
+  void begin_section(const string&);
+  
+  //! Finish current section
+  void end_section();
+  
+  //! Write a plain (POD) value
+  //! \param val value to write
+  template<typename T> void write(const T& val)
+  {
+    const char* c = reinterpret_cast<const char*>(&val);
+    m_data.insert(m_data.end(), c, c + sizeof(T));
+  }
+  
+  //! Write a vector of plain (POD) values preceded by its size
+  //! \param v vector to write
+  template<typename T> void write_vector(const vector<T>& v)
+  {
+    this->write<boost::uint64_t>(v.size());
+    if (v.size() > 0)
+    {
+      const char* c = reinterpret_cast<const char*>(&v[0]);
+      m_data.insert(m_data.end(), c, c + v.size()*sizeof(T));
+    }
+  }
+  
+  //! Write a string preceded by its length
+  void write_string(const string&);
+  
+  //! Size of the checkpoint in bytes
+  size_t size() const { return m_data.size(); }
+  
+  //! Write checkpoint to disk
+  void save(const string&) const;
+  
+private:
+  
+  vector<char> m_data;      //!< Entire content of the checkpoint file
+  size_t m_section_start;   //!< Offset of the payload size of the section being written
+  bool m_in_section;        //!< If true, a section has been started but not finished
+  
+};
+
+/*! Reads a checkpoint written by CheckpointWriter. 
+ *  File is memory mapped and all values are copied directly from the mapping. 
+ *  All reads are bounds checked against the current section.
+ */
+class CheckpointReader
+{
+public:
+  
+  //! Open checkpoint file and index its sections
+  CheckpointReader(const string&);
+  
+  //! Check if a section exists
+  //! \param name section name
+  bool has_section(const string& name) const { return (m_sections.find(name) != m_sections.end()); }
+  
+  //! Position reader at the beginning of a section
+  void open_section(const string&);
+  
+  //! Read a plain (POD) value
+  //! \param val on return, the value
+  template<typename T> void read(T& val)
+  {
+    this->check(sizeof(T));
+    memcpy(&val, m_data + m_pos, sizeof(T));
+    m_pos += sizeof(T);
+  }
+  
+  //! Read a vector of plain (POD) values written with write_vector
+  //! \param v on return, the vector
+  template<typename T> void read_vector(vector<T>& v)
+  {
+    boost::uint64_t n;
+    this->read(n);
+    if (n > (m_end - m_pos)/sizeof(T))
+      throw runtime_error("Corrupted checkpoint file "+m_name+".");
+    v.resize(n);
+    if (n > 0)
+    {
+      memcpy(&v[0], m_data + m_pos, n*sizeof(T));
+      m_pos += n*sizeof(T);
+    }
+  }
+  
+  //! Read a string written with write_string
+  void read_string(string&);
+  
+  //! Get checkpoint file name
+  const string& get_name() const { return m_name; }
+  
+  //! Get format version of the file
+  boost::uint32_t get_version() const { return m_version; }
+  
+private:
+  
+  string m_name;                                     //!< File name
+  shared_ptr<MappedFile> m_file;                     //!< Memory mapped content of the file
+  const char* m_data;                                //!< Beginning of the file content
+  size_t m_pos;                                      //!< Current read position
+  size_t m_end;                                      //!< End of the current section
+  boost::uint32_t m_version;                         //!< Format version of the file
+  map<string, pair<size_t,size_t> > m_sections;      //!< Start and end offsets of all sections
+  
+  //! Make sure that there are enough bytes left in the current section
+  //! \param n number of bytes to be read
+  void check(size_t n) const
+  {
+    if (m_pos + n > m_end)
+      throw runtime_error("Corrupted checkpoint file "+m_name+".");
+  }
+  
+};
+
+typedef shared_ptr<CheckpointReader> CheckpointReaderPtr;
+
+#endif
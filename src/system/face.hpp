@@ -67,6 +67,7 @@ struct Face
                  is_hole(false), 
                  boundary(false), 
                  obtuse(false),
+                 dirty(false),
                  area(0.0),
                  radius(0.0),
                  rc(0,0,0)
@@ -159,6 +160,7 @@ struct Face
   bool is_hole;                //!< If true, this face is actually a hole
   bool boundary;               //!< Face is boundary is one of its edges is boundary
   bool obtuse;                 //!< Face is obtuse if one of its angles is larger than pi/2
+  bool dirty;                  //!< If true, face topology changed and its angles, centre and Jacobian need to be recomputed
   double area;                 //!< Area of the face
   double radius;               //!< Radius of the circumscribed circle
   
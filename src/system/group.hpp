@@ -49,12 +49,18 @@ using boost::shared_ptr;
  *  This class defines groups of particles 
  *  that have same behaviour under integration. For example, 
  *  they can all be integrated with the NVE integrator
+ *
+ *  Particles are kept in a dense list of indices, together with a position 
+ *  map (particle index -> position in the dense list) that allows constant time 
+ *  membership tests and insertions. Removal keeps the order of the remaining 
+ *  particles (dumps print groups in this order), so it costs time proportional 
+ *  to the number of particles that follow the removed one.
  */
 class Group
 {
 public:
   
-  Group() { }
+  Group() : m_size(0) { }
   
   //! Construct a Particle object
   //! \param id group id
@@ -73,26 +79,45 @@ public:
   //! Get size of the group (number of particles)
   int get_size() const { return m_particles.size(); } //!< \return group size
   
+  //! Check if particle belongs to the group
+  //! \param id particle id
+  bool has_particle(int id) const 
+  { 
+    return (id >= 0 && id < static_cast<int>(m_pos.size()) && m_pos[id] >= 0);
+  }
+  
   //! Add particle to a group
   //! \param id particle id to add
   void add_particle(int id) 
   { 
     // protect against same particle being added two or more times to a group
-    if (find(m_particles.begin(),m_particles.end(),id) == m_particles.end())
-    {
-      m_particles.push_back(id);
-      m_size++;
-    }
+    if (!this->has_particle(id))
+      this->append_particle(id);
+  }
+  
+  //! Append a newly created particle to the group
+  //! \note Unlike add_particle, this does not check if particle is already in the group
+  //! \param id particle id to add
+  void append_particle(int id)
+  {
+    if (id >= static_cast<int>(m_pos.size()))
+      m_pos.resize(id+1, -1);
+    m_pos[id] = m_particles.size();
+    m_particles.push_back(id);
+    m_size++;
   }
   
   //! Remove particle from group
   //! \param id particle id to add
   void remove_particle(int id) 
   { 
-    vector<int>::iterator it_p = find(m_particles.begin(), m_particles.end(), id);
-    if (it_p != m_particles.end())
+    if (this->has_particle(id))
     {
-      m_particles.erase(it_p);
+      int k = m_pos[id];
+      m_particles.erase(m_particles.begin() + k);
+      for (unsigned int i = k; i < m_particles.size(); i++)
+        m_pos[m_particles[i]] = i;
+      m_pos[id] = -1;
       m_size--;
     }
   }
@@ -104,19 +129,32 @@ public:
   //! \param id if of the removed particle
   void shift(int id)
   {
-    vector<int>::iterator it_e = find(m_particles.begin(), m_particles.end(), id);
-    if (it_e != m_particles.end())
-    {
-      m_particles.erase(it_e);
-      m_size--;
-    }
+    vector<int> new_idx(m_pos.size(), -1);
+    for (int i = 0; i < static_cast<int>(m_pos.size()); i++)
+      if (i != id)
+        new_idx[i] = (i > id) ? i - 1 : i;
+    this->remap(new_idx);
+  }
+  
+  //! Renumber particles
+  //! When several particles are removed from the system at once, 
+  //! drop the removed ones and renumber the remaining ones
+  //! \param new_idx maps old particle index to the new one (-1 for removed particles)
+  void remap(const vector<int>& new_idx)
+  {
+    unsigned int k = 0;
     for (unsigned int i = 0; i < m_particles.size(); i++)
-      if (m_particles[i] > id)
-        m_particles[i]--;
+      if (new_idx[m_particles[i]] >= 0)
+        m_particles[k++] = new_idx[m_particles[i]];
+    m_particles.erase(m_particles.begin() + k, m_particles.end());
+    m_size = k;
+    this->rebuild_positions();
   }
   
   //! Get particles in the group
-  vector<int>& get_particles() { return m_particles; } //!< \return reference to the vector containing indices of all particles in this group
+  //! \note Do not modify the returned list directly, use add_particle and remove_particle. 
+  //! Iterating over it does not require a copy, unless the group changes during iteration.
+  const vector<int>& get_particles() const { return m_particles; } //!< \return reference to the vector containing indices of all particles in this group
     
 private:  // Make these attributes immutable 
   
@@ -124,6 +162,18 @@ private:  // Make these attributes immutable
   string m_name;                   //!< Name of the group
   int m_size;                      //!< Number of particles in the group 
   vector<int> m_particles;         //!< Contains indices of all particles in the group
+  vector<int> m_pos;               //!< Position of each particle in m_particles (-1 if not in the group)
+  
+  //! Recompute position map from the list of particles
+  void rebuild_positions()
+  {
+    int max_id = -1;
+    for (unsigned int i = 0; i < m_particles.size(); i++)
+      if (m_particles[i] > max_id) max_id = m_particles[i];
+    m_pos.assign(max_id+1, -1);
+    for (unsigned int i = 0; i < m_particles.size(); i++)
+      m_pos[m_particles[i]] = i;
+  }
   
 };
 
@@ -0,0 +1,99 @@
+/* ***************************************************************************
+ *
+ *  Copyright (C) 2013-2016 University of Dundee
+ *  All rights reserved. 
+ *
+ *  This file is part of SAMoS (Soft Active Matter on Surfaces) program.
+ *
+ *  SAMoS is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  SAMoS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ****************************************************************************/
+
+/*!
+ * \file mapped_file.cpp
+ * \author Rastko Sknepnek, sknepnek@gmail.com
+ * \date 18-Oct-2026
+ * \brief Implementation of MappedFile class members.
+ */ 
+
+#include "mapped_file.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/*! Map file into memory
+ *  \param name file name
+ */
+MappedFile::MappedFile(const string& name) : m_data(0), m_size(0), m_mapped(false)
+{
+  int fd = open(name.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw runtime_error("Problem opening file "+name+".");
+  struct stat st;
+  if (fstat(fd, &st) == 0 && st.st_size > 0)
+  {
+    void* addr = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr != MAP_FAILED)
+    {
+      m_data = static_cast<const char*>(addr);
+      m_size = st.st_size;
+      m_mapped = true;
+#ifdef MADV_SEQUENTIAL
+      madvise(addr, m_size, MADV_SEQUENTIAL);
+#endif
+    }
+  }
+  close(fd);
+  if (!m_mapped)
+  {
+    // Fall back to reading the whole file
+    std::ifstream inp(name.c_str(), std::ios::in | std::ios::binary);
+    if (!inp)
+      throw runtime_error("Problem opening file "+name+".");
+    m_buffer.assign(std::istreambuf_iterator<char>(inp), std::istreambuf_iterator<char>());
+    m_size = m_buffer.size();
+    m_data = (m_size > 0) ? &m_buffer[0] : 0;
+  }
+}
+
+//! Unmap the file
+MappedFile::~MappedFile()
+{
+  if (m_mapped)
+    munmap(const_cast<char*>(m_data), m_size);
+}
+
+/*! Find beginnings of all lines. Line i spans [starts[i], starts[i+1]) 
+ *  (including the new line character). The last entry is equal to the file size.
+ *  \param starts on return, contains offsets of the beginnings of all lines
+ */
+void MappedFile::index_lines(vector<size_t>& starts) const
+{
+  starts.clear();
+  size_t pos = 0;
+  while (pos < m_size)
+  {
+    starts.push_back(pos);
+    const void* nl = memchr(m_data + pos, '\n', m_size - pos);
+    if (nl == 0) break;
+    pos = static_cast<const char*>(nl) - m_data + 1;
+  }
+  starts.push_back(m_size);
+}
@@ -0,0 +1,79 @@
+/* ***************************************************************************
+ *
+ *  Copyright (C) 2013-2016 University of Dundee
+ *  All rights reserved. 
+ *
+ *  This file is part of SAMoS (Soft Active Matter on Surfaces) program.
+ *
+ *  SAMoS is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  SAMoS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ****************************************************************************/
+
+/*!
+ * \file mapped_file.hpp
+ * \author Rastko Sknepnek, sknepnek@gmail.com
+ * \date 18-Oct-2026
+ * \brief Declaration of MappedFile class (read-only memory mapped input file).
+ */ 
+
+#ifndef __MAPPED_FILE_HPP__
+#define __MAPPED_FILE_HPP__
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <stdexcept>
+
+using std::string;
+using std::vector;
+using std::runtime_error;
+
+/*! Read-only view of an entire input file. 
+ *  File is memory mapped, so large configuration files are not copied 
+ *  through stream buffers and can be parsed in parallel. If mapping fails 
+ *  (e.g., for empty files or special files), the content is read into memory. 
+ */
+class MappedFile
+{
+public:
+  
+  //! Map file into memory
+  MappedFile(const string&);
+  
+  //! Unmap the file
+  ~MappedFile();
+  
+  //! Pointer to the beginning of the file content
+  const char* data() const { return m_data; }
+  
+  //! File size in bytes
+  size_t size() const { return m_size; }
+  
+  //! Find beginnings of all lines
+  void index_lines(vector<size_t>&) const;
+  
+private:
+  
+  const char* m_data;       //!< Start of the file content
+  size_t m_size;            //!< Size of the file in bytes
+  bool m_mapped;            //!< If true, content is memory mapped (otherwise it is in m_buffer)
+  vector<char> m_buffer;    //!< Holds file content if mapping was not possible
+  
+  // Mapping can not be shared
+  MappedFile(const MappedFile&);
+  MappedFile& operator=(const MappedFile&);
+  
+};
+
+#endif
@@ -48,17 +48,33 @@ static bool comp(vert_angle v1, vert_angle v2)
 void Mesh::reset()
 {
   m_size = 0;  m_nedge = 0;  m_nface = 0;
+  m_topology_version++;
   m_vertices.clear();           
   m_edges.clear();              
   m_faces.clear();              
-  m_edge_map.clear();  
-  m_edge_face.clear();
+  m_dirty_faces.clear();
+}
+
+/*! Prepare the mesh for a rebuild with n vertices. Unlike reset(), 
+ *  vertex objects are kept so that their star buffers can be reused by add_vertex,
+ *  and edge and face arrays keep their capacity.
+ *  \param n number of vertices in the new mesh
+*/
+void Mesh::clear(int n)
+{
+  m_size = 0;  m_nedge = 0;  m_nface = 0;
+  if (static_cast<int>(m_vertices.size()) > n)
+    m_vertices.erase(m_vertices.begin()+n, m_vertices.end());
+  m_edges.clear();              
+  m_faces.clear();              
+  m_dirty_faces.clear();
+  m_topology_version++;
 }
 
 /*! Add and edge to the list of edges. Edge is defined
  *  by the indices of two vertices that belong to it.
- *  We also populate the auxiliary data structure edge_map
- *  that allows us to quickly search over vertex pairs.
+ *  Edge is also recorded as outgoing edge of its first vertex, 
+ *  which is all find_edge needs to locate it.
  *  \param vi index of the 1st vertex
  *  \param vj index of the 2nd vertex
 */
@@ -67,8 +83,24 @@ void Mesh::add_edge(int vi, int vj)
   m_edges.push_back(Edge(m_nedge,vi,vj));
   m_vertices[vi].add_edge(m_nedge);
   m_vertices[vi].add_neighbour(vj);
-  m_edge_map[make_pair(vi,vj)] = m_nedge;
   m_nedge++;
+  m_topology_version++;
+}
+
+/*! Find the half-edge that goes from vertex vi to vertex vj.
+ *  Only outgoing edges of vi are scanned, so the cost is set by 
+ *  the vertex degree and not by the mesh size.
+ *  \param vi index of the 1st vertex
+ *  \param vj index of the 2nd vertex
+ *  \return edge id or -1 if there is no such edge
+*/
+int Mesh::find_edge(int vi, int vj)
+{
+  Vertex& V = m_vertices[vi];
+  for (unsigned int e = 0; e < V.edges.size(); e++)
+    if (m_edges[V.edges[e]].to == vj)
+      return V.edges[e];
+  return -1;
 }
 
 /*! Generates faces from the edge information
@@ -136,6 +168,7 @@ void Mesh::generate_faces()
 /*! Genererate position of the dual vertices */
 void Mesh::generate_dual_mesh()
 {
+  #pragma omp parallel for
   for (int f = 0; f < m_nface; f++)
   {
     Face& face = m_faces[f];
@@ -150,6 +183,7 @@ void Mesh::generate_dual_mesh()
 /*! Update position of the dual vertices as well as the cell centre Jacobian */
 void Mesh::update_dual_mesh()
 {
+  #pragma omp parallel for
   for (int f = 0; f < m_nface; f++)
   {
     Face& face = m_faces[f];
@@ -159,9 +193,63 @@ void Mesh::update_dual_mesh()
       this->compute_centre(f);     
     }
     this->fc_jacobian(f);
+    face.dirty = false;
   }   
+  m_dirty_faces.clear();
 }
 
+/*! Update position of the dual vertices and the cell centre Jacobian 
+ *  only for faces marked as dirty, i.e., those whose topology changed
+ *  (e.g., by an edge flip) since the last update. This is sufficient as 
+ *  long as vertices did not move in the meantime.
+*/
+void Mesh::update_dirty_faces()
+{
+  for (unsigned int i = 0; i < m_dirty_faces.size(); i++)
+  {
+    int f = m_dirty_faces[i];
+    Face& face = m_faces[f];
+    if (!face.is_hole)
+    {
+      this->compute_angles(f);
+      this->compute_centre(f);     
+    }
+    this->fc_jacobian(f);
+    face.dirty = false;
+  }
+  m_dirty_faces.clear();
+}
+
+/*! Order duals and compute dual areas and perimeters for all vertices. 
+ *  Each vertex only reads face centres and writes its own data, so 
+ *  vertices are processed in parallel. Errors are collected and rethrown 
+ *  once the loop is done, since exceptions cannot leave a parallel region.
+*/
+void Mesh::update_dual_vertices()
+{
+  bool failed = false;
+  string error;
+  #pragma omp parallel for
+  for (int i = 0; i < m_size; i++)
+  {
+    try
+    {
+      this->order_dual(i);
+      this->dual_perimeter(i);
+      this->dual_area(i);
+    }
+    catch (runtime_error& e)
+    {
+      #pragma omp critical
+      {
+        failed = true;
+        error = e.what();
+      }
+    }
+  }
+  if (failed)
+    throw runtime_error(error);
+}
 
 /*! Once the mesh is read in, we need to set things like
  *  boundary flags.
@@ -196,7 +284,11 @@ void Mesh::postprocess(bool flag)
   for (int e = 0; e < m_nedge; e++)
   {
     Edge& E = m_edges[e];
-    Edge& Epair = m_edges[m_edge_map[make_pair(E.to,E.from)]];
+    if (E.pair >= 0 && E.pair < m_nedge && m_edges[E.pair].pair == E.id && m_edges[E.pair].from == E.to)
+      continue;   // already paired up from the other side
+    int ep = this->find_edge(E.to,E.from);
+    assert(ep >= 0);
+    Edge& Epair = m_edges[ep];
     E.pair = Epair.id;
     Epair.pair = E.id;
   }
@@ -636,6 +728,10 @@ void Mesh::edge_flip(int e)
   this->compute_angles(Fp.id);
   this->compute_centre(Fp.id);
   
+  this->mark_dirty(F.id);
+  this->mark_dirty(Fp.id);
+  m_topology_version++;
+  
   // Now we need to clean up vertices and their neighbours
   V1.remove_neighbour(V2.id);
   V1.remove_edge(E.id);
@@ -654,18 +750,6 @@ void Mesh::edge_flip(int e)
   V3.add_face(Fp.id);
   V4.add_face(F.id);
   
-  // Finally, we need to update edge_map
-  map<pair<int,int>, int>::iterator it = m_edge_map.find(make_pair(V1.id,V2.id));
-  if (it != m_edge_map.end())
-     m_edge_map.erase(it);
-     
-  it = m_edge_map.find(make_pair(V2.id,V1.id));
-  if (it != m_edge_map.end())
-     m_edge_map.erase(it);
-  
-  m_edge_map[make_pair(V3.id,V4.id)]  = Ep.id;
-  m_edge_map[make_pair(V4.id,V3.id)]  = E.id;
-  
   // Make sure that the vertex stars are all properly ordered
   
   this->order_star(V1.id);
@@ -687,10 +771,36 @@ void Mesh::edge_flip(int e)
     
 }
 
+/*! Check if an internal edge violates the Delaunay condition, i.e., if 
+ *  the sum of the angles opposite to it is larger than pi. Face angles are stored 
+ *  as cosines, so we check the sum of cosines instead.
+ *  \param e edge id
+ *  \return true if the edge needs to be flipped
+*/
+bool Mesh::needs_flip(int e)
+{
+  Edge& E = m_edges[e];
+  Edge& Ep = m_edges[E.pair];
+  if (E.boundary || Ep.boundary)
+    return false;
+  Face& F1 = m_faces[E.face];
+  Face& F2 = m_faces[Ep.face];
+  double angle_1 = F1.get_angle(this->opposite_vertex(E.id));
+  double angle_2 = F2.get_angle(this->opposite_vertex(Ep.id));
+  //return (angle_1 + angle_2 > M_PI);
+  return (angle_1 + angle_2 < 0.0);
+}
+
 /*! Implements the equiangulation of the mesh. This is a procedure where 
  *  all edges that have the sum of their opposing angles larger than pi 
  *  flipped. This procedure is guaranteed to converge and at the end one 
  *  recovers a Delaunday triangulation. 
+ *  
+ *  Mesh is scanned only once to collect edges that violate the Delaunay condition.
+ *  Flipping an edge can only affect the four edges that surround the two 
+ *  triangles sharing it, so only those are put back on the work list. 
+ *  The cost therefore scales with the number of flips (T1 events) and 
+ *  not with the number of sweeps over the whole mesh.
 */
 bool Mesh::equiangulate()
 {
@@ -698,30 +808,37 @@ bool Mesh::equiangulate()
   if (!m_is_triangulation)
     return true;   // We cannot equiangulate a non-triangular mesh
   //cout << "Still in equiangulate" << endl;
-  bool flips = true;
   bool no_flips = true;
-  while (flips)
+  vector<int> work;
+  vector<bool> queued(m_nedge, false);
+  for (int e = 0; e < m_nedge; e++)
+  {
+    int ep = m_edges[e].pair;
+    if (e < ep && this->needs_flip(e))     // handle each pair only once
+    {
+      work.push_back(e);
+      queued[e] = true;
+    }
+  }
+  while (!work.empty())
   {
-    flips = false;
-    for (int e = 0; e < m_nedge; e++)
+    int e = work.back();
+    work.pop_back();
+    queued[e] = false;
+    if (!this->needs_flip(e))   // an earlier flip may have already fixed it
+      continue;
+    this->edge_flip(e);
+    no_flips = false;
+    // Edges of the quadrilateral around the flipped edge (same for both of its halves)
+    int ep = m_edges[e].pair;
+    int quad[4] = { m_edges[e].next, m_edges[m_edges[e].next].next, m_edges[ep].next, m_edges[m_edges[ep].next].next };
+    for (int i = 0; i < 4; i++)
     {
-      Edge& E = m_edges[e];
-      Edge& Ep = m_edges[E.pair];
-      if (!(E.boundary || Ep.boundary))
+      int en = (quad[i] < m_edges[quad[i]].pair) ? quad[i] : m_edges[quad[i]].pair;
+      if (!queued[en])
       {
-        Vertex& V1 = m_vertices[this->opposite_vertex(E.id)];
-        Vertex& V2 = m_vertices[this->opposite_vertex(Ep.id)];
-        Face& F1 = m_faces[E.face];
-        Face& F2 = m_faces[Ep.face];
-        double angle_1 = F1.get_angle(V1.id);
-        double angle_2 = F2.get_angle(V2.id);
-        //if (angle_1 + angle_2 > M_PI)
-        if (angle_1 + angle_2 < 0.0)
-        {
-          this->edge_flip(E.id);
-          flips = true;
-          no_flips = false;
-        }
+        work.push_back(en);
+        queued[en] = true;
       }
     }
   }
@@ -1243,14 +1360,6 @@ bool Mesh::remove_edge_pair(int e)
   V1.remove_face(face.id);
   V2.remove_face(face.id);
   
-  map<pair<int,int>, int>::iterator it = m_edge_map.find(make_pair(V1.id,V2.id));
-  if (it != m_edge_map.end())
-     m_edge_map.erase(it);
-     
-  it = m_edge_map.find(make_pair(V2.id,V1.id));
-  if (it != m_edge_map.end())
-     m_edge_map.erase(it);
-  
   // Remove edge from the list of boundary edges
   m_boundary_edges.erase(find(m_boundary_edges.begin(),m_boundary_edges.end(),E.id));
   
@@ -1309,6 +1418,7 @@ bool Mesh::remove_edge_pair(int e)
   // Update total number of faces
   assert(m_nface == static_cast<int>(m_faces.size()) + 1);
   m_nface = m_faces.size();
+  m_topology_version++;
   
   // Relabel edges
   for (int ee = 0; ee < m_nedge; ee++)
@@ -1351,13 +1461,6 @@ bool Mesh::remove_edge_pair(int e)
     }
   }
   
-  // Relabel edge_map info
-  for (it = m_edge_map.begin(); it != m_edge_map.end(); it++)
-  {
-    if ((*it).second > e1 && (*it).second < e2) (*it).second -= 1;
-    else if ((*it).second > e2) (*it).second -= 2;
-  }
-  
   // Relabel face edge info
   for (int ff = 0; ff < m_nface; ff++)
   {
@@ -1369,6 +1472,11 @@ bool Mesh::remove_edge_pair(int e)
   }
   
   
+  // Face ids have been shifted, so rebuild the list of dirty faces
+  m_dirty_faces.clear();
+  for (int ff = 0; ff < m_nface; ff++)
+    if (m_faces[ff].dirty) m_dirty_faces.push_back(ff);
+  
   // Order affected vertices
   for (unsigned int v = 0; v < affected_vertices.size(); v++)
     this->order_star(affected_vertices[v]);
@@ -1446,6 +1554,7 @@ void Mesh::remove_edge(int e)
   // Update total number of edges
   assert(m_nedge == static_cast<int>(m_edges.size()) + 1);
   m_nedge = m_edges.size();
+  m_topology_version++;
   
   // Relabel edges
   for (int ee = 0; ee < m_nedge; ee++)
@@ -1468,10 +1577,6 @@ void Mesh::remove_edge(int e)
         V.edges[ee]--;
   }
   
-  // Relabel edge_map info
-  for (map<pair<int,int>, int>::iterator it = m_edge_map.begin(); it != m_edge_map.end(); it++)
-    if ((*it).second > e) (*it).second--;
-    
   // Relabel face edge info
   for (int ff = 0; ff < m_nface; ff++)
   {
@@ -1495,6 +1600,7 @@ void Mesh::remove_face(int f)
   // Update total number of faces
   assert(m_nface == static_cast<int>(m_faces.size()) + 1);
   m_nface = m_faces.size();
+  m_topology_version++;
  
   // Relabel face labels
   for (int ff = 0; ff < m_nface; ff++)
@@ -1516,6 +1622,11 @@ void Mesh::remove_face(int f)
         V.dual[ff]--;
     }
   }
+  
+  // Face ids have been shifted, so rebuild the list of dirty faces
+  m_dirty_faces.clear();
+  for (int ff = 0; ff < m_nface; ff++)
+    if (m_faces[ff].dirty) m_dirty_faces.push_back(ff);
 } 
 
 /*! Remove edge face.
@@ -1581,12 +1692,6 @@ bool Mesh::remove_edge_face(int f)
     assert(m_vertices[V.neigh[v]].boundary);
     m_vertices[V.neigh[v]].remove_neighbour(V.id);
     m_vertices[V.neigh[v]].remove_face(f);
-    map<pair<int,int>, int>::iterator it = m_edge_map.find(make_pair(V.id,m_vertices[V.neigh[v]].id));
-    if (it != m_edge_map.end())
-      m_edge_map.erase(it);
-    it = m_edge_map.find(make_pair(m_vertices[V.neigh[v]].id,V.id));
-    if (it != m_edge_map.end())
-      m_edge_map.erase(it);
     affected_vertices.push_back(V.neigh[v]);
   }
   V.neigh.clear();
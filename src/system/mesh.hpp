@@ -90,7 +90,8 @@ public:
            m_nface(0), 
            m_is_triangulation(true), 
            m_max_face_perim(20.0),
-           m_circumcenter(true)
+           m_circumcenter(true),
+           m_topology_version(0)
   {   }
   
   //! Get mesh size
@@ -111,9 +112,6 @@ public:
   //! Get list of faces
   vector<Face>& get_faces() { return m_faces; }
   
-  //! Get edge-face data structure
-  map<pair<int,int>, int>& get_edge_face() { return m_edge_face; }
-  
   //! Get the information about boundary vertex pairs
   vector<pair<int,int> >& get_boundary() { return m_boundary; }
   
@@ -127,6 +125,12 @@ public:
   //! Resets the mesh
   void reset();
   
+  //! Clears the mesh for a rebuild, keeping allocated storage
+  void clear(int);
+  
+  //! Get number of topology changes (e.g. edge flips) since the mesh was created
+  unsigned int get_topology_version() { return m_topology_version; }
+  
   //! Sets the circumcenter flag
   //! \param val value of the circumcenter flag
   void set_circumcenter(bool val) { m_circumcenter = val; }
@@ -143,15 +147,23 @@ public:
   }
   
   //! Add from particle 
+  //! If storage for this vertex is left over from a previous build (see clear()), 
+  //! it is reused.
   //! \param p particle
   void add_vertex(Particle& p)
   {
-    m_vertices.push_back(Vertex(p));
+    if (m_size < static_cast<int>(m_vertices.size()))
+      m_vertices[m_size].reset(p);
+    else
+      m_vertices.push_back(Vertex(p));
     m_size++;
   }
   
   //! Add an edge
   void add_edge(int,int);
+  
+  //! Find half-edge between two vertices
+  int find_edge(int,int);
     
   //! Generate faces of the mesh
   void generate_faces();
@@ -162,6 +174,23 @@ public:
   //! Update dual mesh
   void update_dual_mesh();
   
+  //! Update dual areas and perimeters of all vertices
+  void update_dual_vertices();
+  
+  //! Update dual mesh only for faces changed since the last update
+  void update_dirty_faces();
+  
+  //! Mark face as changed
+  //! \param f face id
+  void mark_dirty(int f)
+  {
+    if (!m_faces[f].dirty)
+    {
+      m_faces[f].dirty = true;
+      m_dirty_faces.push_back(f);
+    }
+  }
+  
   //! Updates vertex positions 
   //! \param p particle
   void update(Particle& p)
@@ -246,17 +275,20 @@ private:
   bool m_is_triangulation;    //!< If true, all faces are triangles (allows more assumptions)
   double m_max_face_perim;    //!< If face perimeter is greater than this value, reject face and treat it as a hole.
   bool m_circumcenter;        //!< If true, compute face circumcenters. Otherwise compute geometric centre. 
+  unsigned int m_topology_version;   //!< Incremented each time mesh connectivity changes
     
   vector<Vertex> m_vertices;           //!< Contains all vertices
   vector<Edge> m_edges;                //!< Contains all edge
   vector<Face> m_faces;                //!< Contains all faces
-  map<pair<int,int>, int> m_edge_map;  //!< Relates vertex indices to edge ids
-  map<pair<int,int>, int> m_edge_face; //!< Relates pairs of faces to edges
   vector<pair<int,int> > m_boundary;   //!< List of vertex pair that are on the boundary
   vector<int> m_boundary_edges;        //!< List of all edges that are at the boundary
   vector<int> m_obtuse_boundary;       //!< List of all boundary edges that have obtuse angle opposite to them  
+  vector<int> m_dirty_faces;           //!< List of all faces changed since the last update of the dual mesh
   PlotArea m_plot_area;                //!< Used to preapre polygonal data for plotting
   
+  //! Check if the edge violates Delaunay condition
+  bool needs_flip(int);
+  
   //! Compute face circumcentre
   void compute_circumcentre(int);
   
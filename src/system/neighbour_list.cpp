@@ -117,6 +117,20 @@ void mark_domains(Delaunay& cdt)
 void NeighbourList::build()
 {
  m_list.clear();
+ m_affine_scale = 1.0;
+ 
+ // Box may have been rescaled since the last build; make sure that cells are still large enough
+ if (m_use_cell_list && !m_cell_list->update_geometry(m_cut+m_pad))
+ {
+   BoxPtr box = m_system->get_box();
+   if (box->Lx > 2.0*(m_cut+m_pad) && box->Ly > 2.0*(m_cut+m_pad) && box->Lz > 2.0*(m_cut+m_pad))
+     m_cell_list = boost::shared_ptr<CellList>(new CellList(m_system,m_msg,m_cut+m_pad));
+   else
+   {
+     m_use_cell_list = false;
+     m_msg->msg(Messenger::INFO,"Box has been rescaled. No longer possible to use cell lists for neighbour list builds.");
+   }
+ }
  
  if (m_remove_detached)
    this->remove_detached();
@@ -148,6 +162,105 @@ void NeighbourList::build()
  this->build_mesh();
 }
 
+/*! Apply affine scaling of all particle positions, (x,y,z) -> (sx*x,sy*y,sz*z), 
+ *  to the neighbour list. Reference positions are scaled together with particles, 
+ *  so that need_update() measures only the non-affine motion. Pair distances shrink 
+ *  at most by the smallest scale factor, which reduces the effective padding. The list 
+ *  is rebuilt only if the padding is used up. 
+ *  \param sx scale factor along x
+ *  \param sy scale factor along y
+ *  \param sz scale factor along z
+ *  \return true if the neighbour list had to be rebuilt
+ */
+bool NeighbourList::affine_rescale(double sx, double sy, double sz)
+{
+  // Mesh needs to be rebuilt anyways
+  if (m_triangulation || m_disable_nlist || static_cast<int>(m_old_state.size()) != m_system->size())
+  {
+    this->build();
+    return true;
+  }
+  for (unsigned int i = 0; i < m_old_state.size(); i++)
+  {
+    m_old_state[i].x *= sx;
+    m_old_state[i].y *= sy;
+    m_old_state[i].z *= sz;
+  }
+  m_affine_scale *= std::min(sx,std::min(sy,sz));
+  if (m_affine_scale*(m_cut+m_pad) <= m_cut)
+  {
+    this->build();
+    return true;
+  }
+  return false;
+}
+
+/*! Incrementally update the neighbour list for particles that were appended 
+ *  to the system since the last build (e.g., after cell division). Each new 
+ *  particle is compared against the reference (build time) positions of the 
+ *  existing particles, and its current position becomes its reference position. 
+ *  Pairs further apart than the list cutoff cannot come within the potential 
+ *  cutoff before need_update() triggers a rebuild, so the list remains valid. 
+ *  Falls back to a full build if the mesh needs to be rebuilt or if the box has been 
+ *  rescaled since the last build.
+ *  \param first index of the first appended particle
+ */
+void NeighbourList::add_particles(int first)
+{
+  int N = m_system->size();
+  if (m_triangulation || m_disable_nlist || m_affine_scale != 1.0 || static_cast<int>(m_old_state.size()) != first || first > N)
+  {
+    this->build();
+    return;
+  }
+  double cut = m_cut+m_pad;
+  double cut2 = cut*cut;
+  for (int i = first; i < N; i++)
+  {
+    Particle& pi = m_system->get_particle(i);
+    m_list.push_back(vector<int>());
+    pi.coordination = 0;
+    vector<int> candidates;
+    if (m_use_cell_list)
+    {
+      // Cells hold particles at their reference positions (populated at the last build)
+      vector<int>& neigh_cells = m_cell_list->get_cell(m_cell_list->get_cell_idx(pi)).get_neighbours();
+      for (vector<int>::iterator it = neigh_cells.begin(); it != neigh_cells.end(); it++)
+      {
+        vector<int>& p_idx_vec = m_cell_list->get_cell(*it).get_particles();
+        candidates.insert(candidates.end(), p_idx_vec.begin(), p_idx_vec.end());
+      }
+    }
+    else
+      for (int j = 0; j < i; j++)
+        candidates.push_back(j);
+    for (unsigned int c = 0; c < candidates.size(); c++)
+    {
+      int j = candidates[c];
+      double dx = pi.x - m_old_state[j].x;
+      double dy = pi.y - m_old_state[j].y;
+      double dz = pi.z - m_old_state[j].z;
+      m_system->apply_periodic(dx,dy,dz);
+      double d2 = dx*dx + dy*dy + dz*dz;
+      if (d2 < cut2)
+      {
+        Particle& pj = m_system->get_particle(j);
+        if (!(m_system->has_exclusions() && m_system->in_exclusion(j, i)))
+          m_list[j].push_back(i);
+        double r = pi.get_radius() + pj.get_radius();
+        if (d2 < r*r)
+        {
+          pi.coordination++;
+          pj.coordination++;
+        }
+      }
+    }
+    m_old_state.push_back(PartPos(pi.x,pi.y,pi.z));
+    if (m_use_cell_list)
+      m_cell_list->add_particle(pi);
+  }
+}
+
 /*! Build faces of the mesh from the particle locations */
 void NeighbourList::build_mesh()
 {
@@ -181,33 +294,33 @@ void NeighbourList::build_nsq(int i)
   double d2;
   
   Particle& pi = m_system->get_particle(i);
+  const double xi = pi.x, yi = pi.y, zi = pi.z, ri = pi.get_radius();
   pi.coordination = 0;
-  for (int j = 0; j < pi.get_id(); j++)
+  for (int j = 0; j < i; j++)
   {
-    Particle& pj = m_system->get_particle(j);
     bool exclude = false;
-    double dx = pi.x - pj.x;
-    double dy = pi.y - pj.y;
-    double dz = pi.z - pj.z;
+    Particle& pj = m_system->get_particle(j);
+    double dx = xi - pj.x;
+    double dy = yi - pj.y;
+    double dz = zi - pj.z;
     m_system->apply_periodic(dx,dy,dz);
     d2 = dx*dx + dy*dy + dz*dz;
-    if (m_system->has_exclusions())
-      if (m_system->in_exclusion(pi.get_id(), pj.get_id()))
-        exclude = true;
-    if (d2 < cut2 && (!exclude))
-      m_list[j].push_back(i);
     if (d2 < cut2)
     {
-      double r = pi.get_radius() + pj.get_radius();
+      if (m_system->has_exclusions())
+        if (m_system->in_exclusion(i, j))
+          exclude = true;
+      if (!exclude)
+        m_list[j].push_back(i);
+      double r = ri + pj.get_radius();
       if (d2 < r*r)
       {
         pi.coordination++;
         pj.coordination++;
       }
     }
-    
   }
-  m_old_state.push_back(PartPos(pi.x,pi.y,pi.z));
+  m_old_state.push_back(PartPos(xi,yi,zi));
   
 }
 
@@ -233,6 +346,7 @@ void NeighbourList::build_cell()
   for (int i = 0; i < N; i++)
   {
     Particle& pi = m_system->get_particle(i);
+    const double xi = pi.x, yi = pi.y, zi = pi.z, ri = pi.get_radius();
     int cell_idx = m_cell_list->get_cell_idx(pi);
     vector<int>& neigh_cells = m_cell_list->get_cell(cell_idx).get_neighbours();  // per design includes this cell as well
     for (vector<int>::iterator it = neigh_cells.begin(); it != neigh_cells.end(); it++)
@@ -241,33 +355,34 @@ void NeighbourList::build_cell()
       vector<int>& p_idx_vec = c.get_particles(); 
       for (unsigned int j = 0; j < p_idx_vec.size(); j++)
       {
-        Particle& pj = m_system->get_particle(p_idx_vec[j]);
+        int pj = p_idx_vec[j];
         bool exclude = false;
-        if (pj.get_id() > pi.get_id())
+        if (pj > i)
         {
-          double dx = pi.x - pj.x;
-          double dy = pi.y - pj.y;
-          double dz = pi.z - pj.z;
+          Particle& ppj = m_system->get_particle(pj);
+          double dx = xi - ppj.x;
+          double dy = yi - ppj.y;
+          double dz = zi - ppj.z;
           m_system->apply_periodic(dx,dy,dz);
           d2 = dx*dx + dy*dy + dz*dz;
-          if (m_system->has_exclusions())
-            if (m_system->in_exclusion(pi.get_id(), pj.get_id()))
-              exclude = true;
-          if (d2 < cut2 && (!exclude))
-            m_list[i].push_back(pj.get_id());
           if (d2 < cut2)
           {
-            double r = pi.get_radius() + pj.get_radius();
+            if (m_system->has_exclusions())
+              if (m_system->in_exclusion(i, pj))
+                exclude = true;
+            if (!exclude)
+              m_list[i].push_back(pj);
+            double r = ri + ppj.get_radius();
             if (d2 < r*r)
             {
              pi.coordination++;
-             pj.coordination++;
+             ppj.coordination++;
             }
           } 
         }
       }
     }
-    m_old_state.push_back(PartPos(pi.x,pi.y,pi.z));
+    m_old_state.push_back(PartPos(xi,yi,zi));
   }
 }
 
@@ -294,7 +409,9 @@ bool NeighbourList::need_update(Particle& p)
     else if (dz < box->zlo) dz += box->Lz;
   }
   
-  if (dx*dx + dy*dy + dz*dz < 0.25*m_pad*m_pad)
+  // Affine compression since the last build eats into the padding
+  double skin = 0.5*(m_affine_scale*(m_cut+m_pad) - m_cut);
+  if (dx*dx + dy*dy + dz*dz < skin*skin)
     return false;
   else
     return true;
@@ -303,13 +420,33 @@ bool NeighbourList::need_update(Particle& p)
 
 /*! Build faces using contact network 
  *  Assumes that contacts have been built. 
+ *  If the contacts are identical to those used in the previous build and the mesh 
+ *  has not changed its topology in the meantime (e.g., by equiangulation), 
+ *  faces are not regenerated and only vertex data and the dual mesh are updated.
  *  \param flag if true do the postprocessing of the mesh
 **/
 void NeighbourList::build_faces(bool flag)
 {
   Mesh& mesh = m_system->get_mesh();
-  mesh.reset();
   int N = m_system->size();
+  boost::uint64_t hash = this->contact_hash();
+  
+  mesh.set_circumcenter(m_circumcenter);
+  mesh.set_max_face_perim(m_max_perim);
+  
+  if (mesh.size() == N && N > 0 && hash == m_contact_hash && mesh.get_topology_version() == m_mesh_version)
+  {
+    vector<Vertex>& vertices = mesh.get_vertices();
+    for (int i = 0; i < N; i++)
+    {
+      Particle& pi = m_system->get_particle(i);
+      vertices[i].N = Vector3d(pi.Nx,pi.Ny,pi.Nz);
+    }
+    m_system->update_mesh();
+    return;
+  }
+  
+  mesh.clear(N);
   for (int i = 0; i < N; i++)
   {
     Particle& pi = m_system->get_particle(i);
@@ -318,15 +455,34 @@ void NeighbourList::build_faces(bool flag)
         mesh.add_edge(i,m_contact_list[i][j]);
   }
 
-  mesh.set_circumcenter(m_circumcenter);
-  mesh.set_max_face_perim(m_max_perim);
   mesh.generate_faces();
   mesh.generate_dual_mesh();
   mesh.postprocess(flag);
+  m_contact_hash = hash;
+  m_mesh_version = mesh.get_topology_version();
   m_system->update_mesh();
   
 }
 
+/*! Compute FNV-1a hash of the contact lists (including order of contacts, since 
+ *  it determines edge labels) and tissue flags of all particles.
+ *  \return hash value
+ */
+boost::uint64_t NeighbourList::contact_hash()
+{
+  boost::uint64_t h = 14695981039346656037ULL;
+  const boost::uint64_t prime = 1099511628211ULL;
+  h = (h ^ static_cast<boost::uint64_t>(m_contact_list.size()))*prime;
+  for (unsigned int i = 0; i < m_contact_list.size(); i++)
+  {
+    h = (h ^ static_cast<boost::uint64_t>(m_system->get_particle(i).in_tissue))*prime;
+    h = (h ^ static_cast<boost::uint64_t>(m_contact_list[i].size()))*prime;
+    for (unsigned int j = 0; j < m_contact_list[i].size(); j++)
+      h = (h ^ static_cast<boost::uint64_t>(m_contact_list[i][j]))*prime;
+  }
+  return h;
+}
+
 #ifdef HAS_CGAL
 /*! Use CGAL to build 2D triangulation. This can be done only in 
  *  the plane, so this function will check if all z-coordinates are zero
@@ -514,39 +670,53 @@ bool NeighbourList::build_triangulation()
 #endif
 
 
-//! Remove all edges that have two or less contacts
+/*! Remove all edges that have two or less contacts.
+ *  Removing a vertex only lowers the number of contacts of its neighbours, so 
+ *  instead of sweeping over all vertices until nothing changes we keep a work list
+ *  seeded with all dangling vertices and push only neighbours of removed vertices.
+ */
 void NeighbourList::remove_dangling()
 {
-  bool done = false;
   int N = m_system->size();
-  while(!done)
+  vector<int> work;
+  vector<bool> queued(N, false);
+  for (int i = 0; i < N; i++)
+    if ((m_contact_list[i].size() > 0) && (m_contact_list[i].size() <= 2))
+    {
+      work.push_back(i);
+      queued[i] = true;
+    }
+  for (unsigned int w = 0; w < work.size(); w++)
   {
-    done = true;
-    for (int i = 0; i < N; i++)
+    int i = work[w];
+    queued[i] = false;
+    if (m_contact_list[i].size() == 2) 
     {
-      if (m_contact_list[i].size() == 2) 
+      int i1 = m_contact_list[i][0];
+      int i2 = m_contact_list[i][1];
+      Particle& p1 = m_system->get_particle(i1);
+      Particle& p2 = m_system->get_particle(i2);
+      if (p1.boundary && p2.boundary)
       {
-        int i1 = m_contact_list[i][0];
-        int i2 = m_contact_list[i][1];
-        Particle& p1 = m_system->get_particle(i1);
-        Particle& p2 = m_system->get_particle(i2);
-        if (p1.boundary && p2.boundary)
-        {
-          if (find(m_contact_list[i1].begin(), m_contact_list[i1].end(),i2) == m_contact_list[i1].end()) m_contact_list[i1].push_back(i2);
-          if (find(m_contact_list[i2].begin(), m_contact_list[i2].end(),i1) == m_contact_list[i2].end()) m_contact_list[i2].push_back(i1);
-        }
+        if (find(m_contact_list[i1].begin(), m_contact_list[i1].end(),i2) == m_contact_list[i1].end()) m_contact_list[i1].push_back(i2);
+        if (find(m_contact_list[i2].begin(), m_contact_list[i2].end(),i1) == m_contact_list[i2].end()) m_contact_list[i2].push_back(i1);
       }
-      if ((m_contact_list[i].size() > 0) && (m_contact_list[i].size() <= 2))
+    }
+    if ((m_contact_list[i].size() > 0) && (m_contact_list[i].size() <= 2))
+    {
+      for (unsigned int j = 0; j < m_contact_list[i].size(); j++)
       {
-        for (unsigned int j = 0; j < m_contact_list[i].size(); j++)
+        int k = m_contact_list[i][j];
+        vector<int>& v = m_contact_list[k];
+        vector<int>::iterator it = find(v.begin(),v.end(),i);
+        if (it != v.end()) v.erase(it);
+        if (!queued[k] && (v.size() > 0) && (v.size() <= 2))
         {
-          vector<int>& v = m_contact_list[m_contact_list[i][j]];
-          vector<int>::iterator it = find(v.begin(),v.end(),i);
-          if (it != v.end()) v.erase(it);
+          work.push_back(k);
+          queued[k] = true;
         }
-        m_contact_list[i].clear();
-        done = false;
       }
+      m_contact_list[i].clear();
     }
   }
 }
@@ -561,32 +731,33 @@ void NeighbourList::remove_dangling()
    if (mesh.size() == 0) return; 
    
    vector<int> to_remove;
-   int offset = 0;  // We need to shift vertex ids to match them in the removal
+   vector<int> new_idx(m_contact_list.size(), -1);   // Maps old to new vertex ids
+   int n = 0;
    for (unsigned int i = 0; i < m_contact_list.size(); i++)
    {
      Particle& pi = m_system->get_particle(i);
      if (pi.in_tissue && m_contact_list[i].size() == 0)
-     {
-       to_remove.push_back(i-offset);
-       offset++;       
-     }
+       to_remove.push_back(i);
+     else
+       new_idx[i] = n++;
    }
+   if (to_remove.size() == 0) return;
 
-   for (unsigned int i = 0; i < to_remove.size(); i++)
+   m_system->remove_particles(to_remove);
+   // Compact contact list in a single pass
+   for (unsigned int i = 0; i < m_contact_list.size(); i++)
    {
-     m_system->remove_particle(to_remove[i]);
-     if (m_contact_list[to_remove[i]].size() != 0)
-       throw runtime_error("Trying to remove connected particle.");
-     else
+     if (new_idx[i] < 0) continue;
+     vector<int>& c = m_contact_list[i];
+     for (unsigned int k = 0; k < c.size(); k++)
      {
-       m_contact_list.erase(m_contact_list.begin() + to_remove[i]);
-       for (unsigned int j = 0; j < m_contact_list.size(); j++)
-       {
-         for (unsigned int k = 0; k < m_contact_list[j].size(); k++)
-           if (m_contact_list[j][k] > to_remove[i]) m_contact_list[j][k]--;
-       }
+       if (new_idx[c[k]] < 0)
+         throw runtime_error("Trying to remove connected particle.");
+       c[k] = new_idx[c[k]];
      }
+     if (new_idx[i] != static_cast<int>(i)) m_contact_list[new_idx[i]].swap(c);
    }
+   m_contact_list.erase(m_contact_list.begin() + n, m_contact_list.end());
  } 
 
 
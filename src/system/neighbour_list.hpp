@@ -36,6 +36,9 @@
 #include <string>
 #include <fstream>
 #include <list>
+#include <algorithm>
+
+#include <boost/cstdint.hpp>
 
 //#include <boost/property_map/property_map.hpp>
 //#include <boost/ref.hpp>
@@ -125,12 +128,15 @@ public:
                                                                                                  m_msg(msg),
                                                                                                  m_cut(cutoff), 
                                                                                                  m_pad(pad), 
+                                                                                                 m_affine_scale(1.0),
                                                                                                  m_triangulation(false),
                                                                                                  m_max_perim(20.0),
                                                                                                  m_circumcenter(true),
                                                                                                  m_disable_nlist(false),
                                                                                                  m_remove_detached(true),
-                                                                                                 m_static_boundary(false)
+                                                                                                 m_static_boundary(false),
+                                                                                                 m_contact_hash(0),
+                                                                                                 m_mesh_version(0)
   {
     m_msg->write_config("nlist.cut",lexical_cast<string>(m_cut));
     m_msg->write_config("nlist.pad",lexical_cast<string>(m_pad));
@@ -247,6 +253,9 @@ public:
   //! Get neighbour list cutoff distance
   double get_cutoff() { return m_cut;  }  //!< \return neighbour list cutoff distance
   
+  //! Get neighbour list padding distance
+  double get_pad() { return m_pad;  }  //!< \return neighbour list padding distance
+  
   //! Rescales neigbour list cutoff
   //! \param scale scale factor
   void rescale_cutoff(double scale)
@@ -268,6 +277,12 @@ public:
   }
   
   
+  //! Apply affine scaling of all particle positions to the neighbour list
+  bool affine_rescale(double, double, double);
+  
+  //! Add particles appended to the system since the last build
+  void add_particles(int);
+  
   //! Build neighbour list
   void build();
   
@@ -284,6 +299,7 @@ private:
   vector<PartPos> m_old_state;     //!< Coordinates of particles right after the build
   double m_cut;                    //!< List build cutoff distance 
   double m_pad;                    //!< Padding distance (m_cut should be set to potential cutoff + m_pad)
+  double m_affine_scale;           //!< Cumulative (smallest) scale factor of affine rescales since the last build
   bool m_use_cell_list;            //!< If true, use cell list to speed up neighbour list builds
   bool m_triangulation;            //!< If true, build Delaunay triangulation for faces
   double m_max_perim;              //!< Maximum value of the perimeter beyond which face becomes a hole.
@@ -292,6 +308,8 @@ private:
   bool m_remove_detached;          //!< If true, remove detached particles (vertices) before rebuilding neighbour list (for cell simulations)
   bool m_static_boundary;          //!< If true, treat tissue boundary as static, i.e., do not add new boundary particles 
   vector<vector<int> >  m_contact_list;    //!< Holds the contact list for each particle
+  boost::uint64_t m_contact_hash;  //!< Hash of the contact lists used for the last mesh build
+  unsigned int m_mesh_version;     //!< Mesh topology version right after the last mesh build
     
   // Actual neighbour list builds
   void build_nsq(int);    //!< Build with N^2 algorithm
@@ -299,6 +317,9 @@ private:
   
    //! Build faces
   void build_faces(bool);
+  
+  //! Compute hash of the contact lists
+  boost::uint64_t contact_hash();
  
   // Remove dangling edges
   void remove_dangling();
@@ -37,6 +37,7 @@
 #include <string>
 
 #include <boost/format.hpp>
+#include <boost/cstdint.hpp>
 
 using std::ostream;
 using boost::format;
@@ -46,7 +47,19 @@ using std::list;
 using std::vector;
 using std::endl;
 
+/*! Floating point type used to store particle positions and forces.
+ *  Building with SINGLE_PRECISION halves the memory traffic of the force loops. 
+ *  Energies and velocities remain in double precision, and particles also keep a double 
+ *  precision copy of their position, to which integrators add displacements (see Particle::move).
+ */
+#ifdef SINGLE_PRECISION
+typedef float Scalar;
+#else
+typedef double Scalar;
+#endif
+
 const int NUM_PART_ATTRIB = 10;  //!< Number of particle attributes
+const int MAX_GROUPS = 64;       //!< Maximum number of groups (size of the group membership mask)
 
 /*! Auxiliary data structure for passing specific types of forces */
 struct ForceType
@@ -71,6 +84,9 @@ public:
   //! \param r particle radius
   Particle(int id, int type, double r) : m_id(id), m_type(type), m_r(r) 
   { 
+#ifdef SINGLE_PRECISION
+    m_xd = 0.0; m_yd = 0.0; m_zd = 0.0;
+#endif
     fx = 0.0; fy = 0.0; fz = 0.0; 
     tau_x = 0.0; tau_y = 0.0; tau_z = 0.0;
     Nx = 0.0; Ny = 0.0; Nz = 0.0;
@@ -88,6 +104,7 @@ public:
     molecule = m_id;   // Default molecule id is particle id (each particle is a molecule)
     bind = -1;         // Ignored by default 
     unbind = -1;       // Ignored by default 
+    group_mask = 0;    // Group membership is set by the System 
   }
   
   //! Get particle id
@@ -242,18 +259,73 @@ public:
     if (find(groups.begin(), groups.end(), name) == groups.end())
       groups.push_back(name);
   }
+  
+  //! Check if the particle belongs to a group 
+  //! \param gid group id 
+  bool in_group(int gid) const { return (group_mask >> gid) & 1; }
+  
+  //! Mark particle as a member of a group
+  //! \param gid group id 
+  void set_group_bit(int gid) { group_mask |= (static_cast<boost::uint64_t>(1) << gid); }
+  
+  //! Remove particle's membership in a group
+  //! \param gid group id 
+  void clear_group_bit(int gid) { group_mask &= ~(static_cast<boost::uint64_t>(1) << gid); }
 
   //! Get the entire force type data structure
   map<string,ForceType>& get_force_type() { return m_force_type; }
   
+  //! Displace the particle
+  //! \param dx x component of the displacement
+  //! \param dy y component of the displacement
+  //! \param dz z component of the displacement
+  //! \note In single precision builds the displacement is added to the double precision
+  //! copy of the position, which is then rounded into x, y and z read by the force kernels.
+  void move(double dx, double dy, double dz)
+  {
+#ifdef SINGLE_PRECISION
+    this->sync_position();
+    m_xd += dx;  m_yd += dy;  m_zd += dz;
+    x = m_xd;  y = m_yd;  z = m_zd;
+#else
+    x += dx;  y += dy;  z += dz;
+#endif
+  }
+  
+  //! Set particle position
+  //! \param x_ x coordinate
+  //! \param y_ y coordinate
+  //! \param z_ z coordinate
+  void set_position(double x_, double y_, double z_)
+  {
+#ifdef SINGLE_PRECISION
+    m_xd = x_;  m_yd = y_;  m_zd = z_;
+#endif
+    x = x_;  y = y_;  z = z_;
+  }
+  
+  //! Get particle position at full (double) precision
+  //! \param x_ on return, x coordinate
+  //! \param y_ on return, y coordinate
+  //! \param z_ on return, z coordinate
+  void get_position(double& x_, double& y_, double& z_)
+  {
+#ifdef SINGLE_PRECISION
+    this->sync_position();
+    x_ = m_xd;  y_ = m_yd;  z_ = m_zd;
+#else
+    x_ = x;  y_ = y;  z_ = z;
+#endif
+  }
+  
   ///@{
-  double x, y, z;              //!< Position in the embedding 3d flat space
+  Scalar x, y, z;              //!< Position in the embedding 3d flat space
   //@}
   ///@{
   double vx, vy, vz;           //!< Components of the particle velocity
   //@}
   ///@{
-  double fx, fy, fz;           //!< Components of the force acting on the particle 
+  Scalar fx, fy, fz;           //!< Components of the force acting on the particle 
   //@}
   ///@{
   double tau_x, tau_y, tau_z;  //!< Components of the vector that handles director updates (torque in a sense?)
@@ -276,6 +348,7 @@ public:
   bool boundary;               //!< Flag used to distinguish particle at the boundary for tissue simulations
   bool in_tissue;              //!< Flag used to distinguish particles that belong to a tissue (part of triangulation) and those that do not
   list<string> groups;         //!< List of all groups particle belongs to.
+  boost::uint64_t group_mask;  //!< Bit mask of group ids particle belongs to (mirrors groups, used for fast membership tests)
   vector<int> bonds;           //!< List of all bonds this particle belongs to
   vector<int> angles;          //!< List of all angles this particle belongs to
   vector<int> boundary_neigh;  //!< For a boundary particle (tissue simulation) list all its boundary neighbours
@@ -297,6 +370,19 @@ private:  // Make these attributes immutable
   map<string,double> m_pot_eng;   //!< Holds current value of the potential energy of a given type 
   map<string,double> m_align_eng; //!< Holds alignment potential energy of a given type
   map<string,ForceType> m_force_type;  //<! Holds components of a given type of the force (e.g, soft repulsion, active force, etc.)
+#ifdef SINGLE_PRECISION
+  double m_xd, m_yd, m_zd; //!< Double precision copy of the position (x, y and z are rounded from it)
+  
+  //! Take over coordinates that have been set directly (e.g., by a constraint or periodic wrapping)
+  //! A coordinate that no longer matches the rounded double precision copy has been changed
+  //! through x, y or z, and the double precision copy is reset to it.
+  void sync_position()
+  {
+    if (static_cast<Scalar>(m_xd) != x) m_xd = x;
+    if (static_cast<Scalar>(m_yd) != y) m_yd = y;
+    if (static_cast<Scalar>(m_zd) != z) m_zd = z;
+  }
+#endif
     
 };
 
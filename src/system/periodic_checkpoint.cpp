@@ -0,0 +1,142 @@
+/* ***************************************************************************
+ *
+ *  Copyright (C) 2013-2016 University of Dundee
+ *  All rights reserved. 
+ *
+ *  This file is part of SAMoS (Soft Active Matter on Surfaces) program.
+ *
+ *  SAMoS is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  SAMoS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ****************************************************************************/
+
+/*!
+ * \file periodic_checkpoint.cpp
+ * \author Rastko Sknepnek, sknepnek@gmail.com
+ * \date 18-Oct-2026
+ * \brief Implementation of PeriodicCheckpoint class members.
+ */ 
+
+#include "periodic_checkpoint.hpp"
+
+#include <cstdio>
+
+#include <boost/bind.hpp>
+#include <boost/format.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+using boost::format;
+using boost::lexical_cast;
+
+/*! Construct periodic checkpoint object
+ *  \param msg Handles system wide messages
+ *  \param name Base file name for checkpoints
+ *  \param params parameters (freq - checkpoint frequency, keep - number of files to keep)
+ *  \param step current time step (no checkpoint is taken at this step)
+ */
+PeriodicCheckpoint::PeriodicCheckpoint(MessengerPtr msg, const string& name, pairs_type& params, int step) : m_msg(msg), 
+                                                                                                             m_name(name),
+                                                                                                             m_last_step(step),
+                                                                                                             m_pending(false),
+                                                                                                             m_write_time(0.0)
+{
+  m_freq = lexical_cast<int>(params["freq"]);
+  if (m_freq <= 0)
+  {
+    m_msg->msg(Messenger::ERROR,"Checkpoint frequency has to be positive.");
+    throw runtime_error("Illegal checkpoint frequency.");
+  }
+  m_msg->msg(Messenger::INFO,"Writing checkpoint "+name+" every "+params["freq"]+" time steps.");
+  m_msg->write_config("checkpoint."+name+".freq",params["freq"]);
+  if (params.find("keep") == params.end())
+  {
+    m_msg->msg(Messenger::WARNING,"Number of checkpoint files to keep not specified. Using default 2.");
+    m_keep = 2;
+  }
+  else
+  {
+    m_keep = lexical_cast<int>(params["keep"]);
+    if (m_keep < 1)
+    {
+      m_msg->msg(Messenger::ERROR,"At least one checkpoint file has to be kept.");
+      throw runtime_error("Illegal number of checkpoint files to keep.");
+    }
+    m_msg->msg(Messenger::INFO,"Keeping last "+params["keep"]+" checkpoint files.");
+  }
+  m_msg->write_config("checkpoint."+name+".keep",lexical_cast<string>(m_keep));
+}
+
+//! Wait for the last checkpoint to be written
+PeriodicCheckpoint::~PeriodicCheckpoint()
+{
+  if (m_thread.joinable())
+    m_thread.join();
+}
+
+/*! Hand a snapshot over to the background writer. If the previous 
+ *  write is still in progress, wait for it to finish first.
+ *  \param ckp snapshot of the simulation
+ *  \param step time step of the snapshot
+ *  \param snapshot_time time (in seconds) it took to take the snapshot
+ */
+void PeriodicCheckpoint::submit(shared_ptr<CheckpointWriter> ckp, int step, double snapshot_time)
+{
+  boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+  this->finish();
+  double wait_time = (boost::posix_time::microsec_clock::universal_time() - start).total_microseconds()*1e-6;
+  m_ckp = ckp;
+  m_file = m_name+"_"+lexical_cast<string>(format("%010d") % step)+".ckp";
+  m_last_step = step;
+  m_pending = true;
+  m_thread = boost::thread(boost::bind(&PeriodicCheckpoint::write, this));
+  m_msg->msg(Messenger::INFO,"Checkpoint "+m_file+" ("+lexical_cast<string>(ckp->size())+" bytes). Snapshot took "+lexical_cast<string>(snapshot_time)+" s, waited "+lexical_cast<string>(wait_time)+" s for the previous write.");
+}
+
+//! Wait for the pending write to finish and report its outcome
+void PeriodicCheckpoint::finish()
+{
+  if (m_thread.joinable())
+    m_thread.join();
+  if (!m_pending)
+    return;
+  m_pending = false;
+  m_ckp.reset();
+  if (m_error != "")
+    m_msg->msg(Messenger::WARNING,"Writing checkpoint "+m_file+" failed: "+m_error);
+  else
+    m_msg->msg(Messenger::INFO,"Checkpoint "+m_file+" written in "+lexical_cast<string>(m_write_time)+" s.");
+}
+
+//! Write snapshot and remove old files (runs in the background thread)
+void PeriodicCheckpoint::write()
+{
+  boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+  m_error = "";
+  try
+  {
+    m_ckp->save(m_file);
+  }
+  catch (std::exception& e)
+  {
+    m_error = e.what();
+    return;
+  }
+  m_write_time = (boost::posix_time::microsec_clock::universal_time() - start).total_microseconds()*1e-6;
+  m_files.push_back(m_file);
+  while (static_cast<int>(m_files.size()) > m_keep)
+  {
+    std::remove(m_files.front().c_str());
+    m_files.pop_front();
+  }
+}
@@ -0,0 +1,103 @@
+/* ***************************************************************************
+ *
+ *  Copyright (C) 2013-2016 University of Dundee
+ *  All rights reserved. 
+ *
+ *  This file is part of SAMoS (Soft Active Matter on Surfaces) program.
+ *
+ *  SAMoS is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  SAMoS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ****************************************************************************/
+
+/*!
+ * \file periodic_checkpoint.hpp
+ * \author Rastko Sknepnek, sknepnek@gmail.com
+ * \date 18-Oct-2026
+ * \brief Declaration of PeriodicCheckpoint class (asynchronous checkpoints during a run).
+ */ 
+
+#ifndef __PERIODIC_CHECKPOINT_HPP__
+#define __PERIODIC_CHECKPOINT_HPP__
+
+#include <string>
+#include <deque>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+
+#include "checkpoint.hpp"
+#include "messenger.hpp"
+#include "parse_parameters.hpp"
+
+using std::string;
+using std::deque;
+
+using boost::shared_ptr;
+
+/*! Writes checkpoints periodically during a run. 
+ *  
+ *  The main loop takes a snapshot of the simulation into a CheckpointWriter 
+ *  (in memory) at a step boundary and hands it over. The snapshot is then written 
+ *  and flushed to the disk in a background thread while the simulation continues. 
+ *  At most one write is in flight; if the previous one has not finished when the next 
+ *  snapshot is due, the main loop waits for it, so the stall is bounded by the time 
+ *  needed to write a single checkpoint. Only the last few checkpoints are kept.
+ *
+ *  Checkpoints are written into files name_<time step>.ckp.
+ *  \note Background thread does not send any messages (Messenger is not thread safe). 
+ *  Outcome of each write is reported by the main thread when the next one is submitted.
+ */
+class PeriodicCheckpoint
+{
+public:
+  
+  //! Constructor
+  PeriodicCheckpoint(MessengerPtr, const string&, pairs_type&, int);
+  
+  //! Wait for the last checkpoint to be written
+  ~PeriodicCheckpoint();
+  
+  //! Check if a checkpoint should be taken at this step
+  //! \param step current time step
+  bool due(int step) { return (step % m_freq == 0 && step != m_last_step); }
+  
+  //! Hand a snapshot over to the background writer
+  void submit(shared_ptr<CheckpointWriter>, int, double);
+  
+  //! Wait for the pending write to finish and report it
+  void finish();
+  
+private:
+  
+  MessengerPtr m_msg;                     //!< Handles messages sent to output
+  string m_name;                          //!< Base name of the checkpoint files
+  int m_freq;                             //!< Take checkpoint every m_freq time steps
+  int m_keep;                             //!< Number of checkpoint files to keep
+  int m_last_step;                        //!< Time step of the last checkpoint
+  boost::thread m_thread;                 //!< Background writer thread
+  bool m_pending;                         //!< If true, a write has been started and not reported yet
+  shared_ptr<CheckpointWriter> m_ckp;     //!< Snapshot being written
+  string m_file;                          //!< File the snapshot is being written into
+  string m_error;                         //!< Error message of the last write (empty on success)
+  double m_write_time;                    //!< Time (in seconds) it took to write the last checkpoint
+  deque<string> m_files;                  //!< Checkpoint files on disk (oldest first)
+  
+  //! Write snapshot and remove old files (runs in the background thread)
+  void write();
+  
+};
+
+typedef shared_ptr<PeriodicCheckpoint> PeriodicCheckpointPtr;
+
+#endif
@@ -28,6 +28,10 @@
  */ 
 
 #include "system.hpp"
+#include "mapped_file.hpp"
+
+#include <cstring>
+#include <cstdlib>
 
 
 // Set of auxiliary functions that help parse lines of the input file and
@@ -44,6 +48,84 @@ static vector<string> split_line(const string& str)
   return split_string;  
 }
 
+//! Fields recognised in the "keys:" format of the input file
+enum InputField { F_ID, F_TYPE, F_RADIUS, F_X, F_Y, F_Z, F_VX, F_VY, F_VZ, F_NX, F_NY, F_NZ, F_OMEGA, F_LENGTH, 
+                  F_IX, F_IY, F_IZ, F_PARENT, F_NVX, F_NVY, F_NVZ, F_AREA, F_MASS, F_MOLECULE, F_BOUNDARY, F_IN_TISSUE, 
+                  N_INPUT_FIELDS };
+
+//! Key names of the fields (in the order of InputField)
+static const char* input_field_names[N_INPUT_FIELDS] = { "id", "type", "radius", "x", "y", "z", "vx", "vy", "vz", "nx", "ny", "nz", "omega", "length",
+                                                         "ix", "iy", "iz", "parent", "nvx", "nvy", "nvz", "area", "mass", "molecule", "boundary", "in_tissue" };
+
+//! Checks if character separates fields (same separators as in split_line)
+//! \param c character to check
+static inline bool is_separator(char c)
+{
+  return (c == ' ' || c == '\t' || c == ',' || c == '\r' || c == '\n' || c == '\f' || c == '\v');
+}
+
+//! Splits a line into fields without copying it
+//! \param begin start of the line
+//! \param end end of the line 
+//! \param fb on return, beginnings of all fields
+//! \param fe on return, ends of all fields
+//! \return number of fields
+static int split_fields(const char* begin, const char* end, vector<const char*>& fb, vector<const char*>& fe)
+{
+  fb.clear();  fe.clear();
+  const char* c = begin;
+  while (c < end)
+  {
+    while (c < end && is_separator(*c)) c++;
+    if (c == end) break;
+    fb.push_back(c);
+    while (c < end && !is_separator(*c)) c++;
+    fe.push_back(c);
+  }
+  return fb.size();
+}
+
+//! Converts field into a floating point number
+//! \param col column of the field (negative if the column is not present; value is then left unchanged)
+//! \param fb beginnings of all fields in the line
+//! \param fe ends of all fields in the line
+//! \param val on return, the number
+//! \return false if the field is missing or is not a number
+template<typename T>
+static bool field_to_double(int col, const vector<const char*>& fb, const vector<const char*>& fe, T& val)
+{
+  if (col < 0) return true;
+  if (col >= static_cast<int>(fb.size())) return false;
+  char buf[64];
+  size_t len = fe[col] - fb[col];
+  if (len >= sizeof(buf)) return false;
+  memcpy(buf, fb[col], len);
+  buf[len] = '\0';
+  char* stop;
+  val = strtod(buf, &stop);
+  return (*stop == '\0');
+}
+
+//! Converts field into an integer
+//! \param col column of the field (negative if the column is not present; value is then left unchanged)
+//! \param fb beginnings of all fields in the line
+//! \param fe ends of all fields in the line
+//! \param val on return, the number
+//! \return false if the field is missing or is not an integer
+static bool field_to_int(int col, const vector<const char*>& fb, const vector<const char*>& fe, int& val)
+{
+  if (col < 0) return true;
+  if (col >= static_cast<int>(fb.size())) return false;
+  char buf[64];
+  size_t len = fe[col] - fb[col];
+  if (len >= sizeof(buf)) return false;
+  memcpy(buf, fb[col], len);
+  buf[len] = '\0';
+  char* stop;
+  val = static_cast<int>(strtol(buf, &stop, 10));
+  return (*stop == '\0');
+}
+
 
 /*! System constructor
  *  The constructor reads in coordinates from a file.
@@ -67,8 +149,10 @@ System::System(const string& input_filename, MessengerPtr msg, BoxPtr box) : m_m
                                                                              m_periodic(false),
                                                                              m_force_nlist_rebuild(false),
                                                                              m_nlist_rescale(1.0),
+                                                                             m_nlist_append(-1),
                                                                              m_current_particle_flag(0),
                                                                              m_dt(0.0),
+                                                                             m_dt_current(0.0),
                                                                              m_max_mesh_iter(100),
                                                                              m_boundary_type(1),
                                                                              m_has_boundary_neighbours(false),
@@ -114,8 +198,12 @@ System::System(const string& input_filename, MessengerPtr msg, BoxPtr box) : m_m
   m_msg->msg(Messenger::INFO,"Reading particle coordinates from file: "+input_filename);
   m_msg->write_config("system.input_file",input_filename);
   
+  // Files in the "keys:" format are read with the fast reader
+  bool fast_read = this->read_keys_fast(input_filename, has_boundary, types);
+  if (fast_read) has_keys = true;
+  
   inp.exceptions ( std::ifstream::badbit ); // need to reset ios exceptions to avoid EOF failure of getline
-  while ( getline(inp, line) )
+  while ( !fast_read && getline(inp, line) )
   {
     trim(line);
     to_lower(line);
@@ -407,6 +495,7 @@ System::System(const string& input_filename, MessengerPtr msg, BoxPtr box) : m_m
   {
     m_group["all"]->add_particle(i);
     m_particles[i].add_group("all");
+    m_particles[i].set_group_bit(m_group["all"]->get_id());
     if (has_boundary)
     {
       Particle& p = m_particles[i];
@@ -414,21 +503,25 @@ System::System(const string& input_filename, MessengerPtr msg, BoxPtr box) : m_m
       {
         m_group["tissue"]->add_particle(i);
         m_particles[i].add_group("tissue");
+        m_particles[i].set_group_bit(m_group["tissue"]->get_id());
         if (p.boundary)
         {
           m_group["boundary"]->add_particle(i);
           m_particles[i].add_group("boundary");
+          m_particles[i].set_group_bit(m_group["boundary"]->get_id());
         }
         else
         {
           m_group["internal"]->add_particle(i);
           m_particles[i].add_group("internal");
+          m_particles[i].set_group_bit(m_group["internal"]->get_id());
         }
       }
       else
       {
         m_group["environment"]->add_particle(i);
         m_particles[i].add_group("environment");
+        m_particles[i].set_group_bit(m_group["environment"]->get_id());
       }
     }
   }
@@ -451,6 +544,183 @@ System::System(const string& input_filename, MessengerPtr msg, BoxPtr box) : m_m
   m_has_exclusions = false;
 }
 
+/*! Read input file in the "keys:" format. The file is memory mapped and 
+ *  key columns are resolved once. Lines are then parsed in parallel straight 
+ *  into the particle array. Semantics (defaults, checks, groups) are the same 
+ *  as in the line by line reader in the constructor. 
+ *  \param input_filename name of the input file
+ *  \param has_boundary on return, true if boundary flags are present
+ *  \param types on return, list of all particle types
+ *  \return false if the file is not in the "keys:" format (nothing is read in that case)
+ */
+bool System::read_keys_fast(const string& input_filename, bool& has_boundary, vector<int>& types)
+{
+  MappedFile file(input_filename);
+  const char* data = file.data();
+  vector<size_t> starts;
+  file.index_lines(starts);
+  int n_lines = starts.size() - 1;
+  vector<const char*> fb, fe;
+  
+  // Header is the first non-empty line 
+  int header = 0, n_cols = 0;
+  for ( ; header < n_lines; header++)
+  {
+    n_cols = split_fields(data + starts[header], data + starts[header+1], fb, fe);
+    if (n_cols > 0) break;
+  }
+  if (header == n_lines || to_lower_copy(string(fb[0], fe[0])) != "keys:")
+    return false;
+  
+  // Resolve columns once
+  int col[N_INPUT_FIELDS];
+  for (int f = 0; f < N_INPUT_FIELDS; f++) col[f] = -1;
+  for (int c = 1; c < n_cols; c++)
+  {
+    string key = to_lower_copy(string(fb[c], fe[c]));
+    for (int f = 0; f < N_INPUT_FIELDS; f++)
+      if (key == input_field_names[f]) 
+        col[f] = c-1;
+    m_msg->msg(Messenger::INFO,"Column " + lexical_cast<string>(c) + " of input file is : " + key + ".");
+    cout << "Column " << lexical_cast<string>(c) <<  " of input file is : " << key << endl;
+  }
+  if (col[F_BOUNDARY] >= 0)  // Create two groups for boundary and internal particles
+  {
+    m_group["tissue"] = make_shared<Group>(Group(1,"tissue"));
+    m_group["environment"] = make_shared<Group>(Group(2,"environment"));
+    m_group["boundary"] = make_shared<Group>(Group(3,"boundary"));
+    m_group["internal"] = make_shared<Group>(Group(4,"internal"));
+    m_num_groups = 5;
+    m_msg->msg(Messenger::INFO,"Generated groups 'tissue', 'environment', 'boundary' and 'internal' to distinguish particles beloging to the tissue or not.");
+    m_msg->msg(Messenger::INFO,"Generated groups 'boundary' and 'internal' to distinguish if tissue particles are inside or on the boundary.");
+    has_boundary = true;
+  }
+  
+  // Find all data lines (skip empty lines and comments)
+  vector<int> lines;
+  for (int l = header + 1; l < n_lines; l++)
+  {
+    const char* c = data + starts[l];
+    const char* end = data + starts[l+1];
+    while (c < end && is_separator(*c)) c++;
+    if (c < end && *c != '#') 
+      lines.push_back(l);
+  }
+  
+  // Parse all lines in parallel
+  int N = lines.size();
+  m_particles.assign(N, Particle(0, 1, 1.0));
+  enum { OK, BAD_FIELD, BAD_TYPE, OUT_X, OUT_Y, OUT_Z, NO_BOUNDARY };
+  int error = OK, error_line = n_lines, error_id = 0;
+  #pragma omp parallel
+  {
+    vector<const char*> tb, te;
+    #pragma omp for schedule(static)
+    for (int i = 0; i < N; i++)
+    {
+      int l = lines[i];
+      split_fields(data + starts[l], data + starts[l+1], tb, te);
+      int id = i, tp = 1;
+      double r = 1.0;
+      bool ok = field_to_int(col[F_ID], tb, te, id) && field_to_int(col[F_TYPE], tb, te, tp) && field_to_double(col[F_RADIUS], tb, te, r);
+      Particle p(id, tp, r);
+      p.x = 0.0;  p.y = 0.0;  p.z = 0.0;
+      p.vx = 0.0; p.vy = 0.0; p.vz = 0.0;
+      p.nx = 1.0; p.ny = 0.0; p.nz = 0.0;
+      p.omega = 0.0;
+      p.ix = 0;   p.iy = 0;   p.iz = 0;
+      double length = 1.0, area = p.A0, molecule = p.molecule;
+      int parent = p.get_parent(), boundary = 0, in_tissue = 0;
+      ok = ok && field_to_double(col[F_X], tb, te, p.x) && field_to_double(col[F_Y], tb, te, p.y) && field_to_double(col[F_Z], tb, te, p.z);
+      ok = ok && field_to_double(col[F_VX], tb, te, p.vx) && field_to_double(col[F_VY], tb, te, p.vy) && field_to_double(col[F_VZ], tb, te, p.vz);
+      ok = ok && field_to_double(col[F_NX], tb, te, p.nx) && field_to_double(col[F_NY], tb, te, p.ny) && field_to_double(col[F_NZ], tb, te, p.nz);
+      ok = ok && field_to_double(col[F_OMEGA], tb, te, p.omega) && field_to_double(col[F_LENGTH], tb, te, length);
+      ok = ok && field_to_int(col[F_IX], tb, te, p.ix) && field_to_int(col[F_IY], tb, te, p.iy) && field_to_int(col[F_IZ], tb, te, p.iz);
+      ok = ok && field_to_int(col[F_PARENT], tb, te, parent);
+      ok = ok && field_to_double(col[F_NVX], tb, te, p.Nx) && field_to_double(col[F_NVY], tb, te, p.Ny) && field_to_double(col[F_NVZ], tb, te, p.Nz);
+      ok = ok && field_to_double(col[F_AREA], tb, te, area) && field_to_double(col[F_MASS], tb, te, p.mass) && field_to_double(col[F_MOLECULE], tb, te, molecule);
+      ok = ok && field_to_int(col[F_BOUNDARY], tb, te, boundary) && field_to_int(col[F_IN_TISSUE], tb, te, in_tissue);
+      
+      int err = OK;
+      if (!ok) err = BAD_FIELD;
+      else if (tp < 1) err = BAD_TYPE;
+      else if (p.x < m_box->xlo || p.x > m_box->xhi) err = OUT_X;
+      else if (p.y < m_box->ylo || p.y > m_box->yhi) err = OUT_Y;
+      else if (p.z < m_box->zlo || p.z > m_box->zhi) err = OUT_Z;
+      else if (in_tissue != 0 && col[F_BOUNDARY] < 0) err = NO_BOUNDARY;
+      if (err != OK)
+      {
+        #pragma omp critical
+        if (l < error_line)
+        {
+          error = err;  error_line = l;  error_id = id;
+        }
+        continue;
+      }
+      
+      p.set_length(length);
+      p.set_parent(parent);
+      if (col[F_AREA] >= 0)
+      {
+        p.set_default_area(area);
+        p.A0 = area;
+      }
+      p.molecule = static_cast<int>(molecule);
+      if (col[F_BOUNDARY] >= 0)
+      {
+        p.boundary = (boundary != 0);
+        if (col[F_IN_TISSUE] < 0)  // boundary flags given but no in_tissue flag set, assume all in tissue
+          p.in_tissue = true;
+      }
+      if (in_tissue != 0) 
+        p.in_tissue = true;
+      m_particles[i] = p;
+    }
+  }
+  
+  switch (error)
+  {
+    case BAD_FIELD:
+      m_msg->msg(Messenger::ERROR,"Could not parse line "+lexical_cast<string>(error_line+1)+" of the input file.");
+      throw runtime_error("Error parsing input file.");
+    case BAD_TYPE:
+      m_msg->msg(Messenger::ERROR,"Particle type has to be positive integer.");
+      throw runtime_error("Wrong particle type.");
+    case OUT_X:
+      m_msg->msg(Messenger::ERROR,"X coordinate of particle "+lexical_cast<string>(error_id)+" is outside simulation box. Please update box size.");
+      throw runtime_error("Particle outside the box.");
+    case OUT_Y:
+      m_msg->msg(Messenger::ERROR,"Y coordinate of particle "+lexical_cast<string>(error_id)+" is outside simulation box. Please update box size.");
+      throw runtime_error("Particle outside the box.");
+    case OUT_Z:
+      m_msg->msg(Messenger::ERROR,"Z coordinate of particle "+lexical_cast<string>(error_id)+" is outside simulation box. Please update box size.");
+      throw runtime_error("Particle outside the box.");
+    case NO_BOUNDARY:
+      m_msg->msg(Messenger::ERROR,"For tissue simulations (in_tissue flag) boundary flag need to be specified.");
+      throw runtime_error("No boundary flag specified for tissue simulations.");
+  }
+  
+  // Bookkeeping that depends on the order of particles
+  for (int i = 0; i < N; i++)
+  {
+    Particle& p = m_particles[i];
+    if (find(types.begin(), types.end(), p.get_type()) == types.end())
+      types.push_back(p.get_type());
+    if (col[F_MOLECULE] >= 0)
+    {
+      if (p.molecule < static_cast<int>(m_molecules.size()))
+        m_molecules[p.molecule].push_back(p.get_id());
+      else 
+        m_molecules.push_back(vector<int>(1,p.get_id()));
+    }
+    if (p.boundary)
+      m_boundary.push_back(p.get_id());
+    p.set_flag(m_current_particle_flag);
+    m_current_particle_flag++;
+  }
+  return true;
+}
+
 /*! Generate a group of particles
     \param name name of the group
     \param param Contains information about all parameters
@@ -461,6 +731,11 @@ System::System(const string& input_filename, MessengerPtr msg, BoxPtr box) : m_m
 */
 void System::make_group(const string name, pairs_type& param)
 {
+  if (m_num_groups >= MAX_GROUPS)
+  {
+    m_msg->msg(Messenger::ERROR,"Cannot create group "+name+". Maximum number of groups is "+lexical_cast<string>(MAX_GROUPS)+".");
+    throw runtime_error("Too many particle groups.");
+  }
   m_group[name] = make_shared<Group>(Group(m_num_groups++, name));
   map<string, vector<bool> > to_add;
   if (param.find("type") != param.end())
@@ -563,6 +838,7 @@ void System::make_group(const string name, pairs_type& param)
       Particle& p = m_particles[i];
       m_group[name]->add_particle(i);
       p.add_group(name);
+      p.set_group_bit(m_group[name]->get_id());
     }
   }
   
@@ -577,9 +853,13 @@ void System::make_group(const string name, pairs_type& param)
 void System::add_particle(Particle& p)
 {
   p.set_flag(m_current_particle_flag);
-  m_particles.push_back(p);
+  p.group_mask = 0;
   for (list<string>::iterator it = p.groups.begin(); it != p.groups.end(); it++)
+  {
     m_group[*it]->add_particle(p.get_id());
+    p.set_group_bit(m_group[*it]->get_id());
+  }
+  m_particles.push_back(p);
   if (p.boundary) m_boundary.push_back(p.get_id());
   if (p.molecule < m_molecules.size())
     m_molecules[p.molecule].push_back(p.get_id());
@@ -587,58 +867,144 @@ void System::add_particle(Particle& p)
     m_molecules.push_back(vector<int>(1,p.get_id()));
   // We need to force neighbour list rebuild
   m_force_nlist_rebuild = true;
+  m_nlist_append = -1;
   m_current_particle_flag++;
 }
 
+/*! Queue particle for insertion into the system. Particle is 
+ *  assigned the id it will have once all queued particles are committed.
+ *  \param p Particle to add
+ */ 
+void System::stage_particle(Particle& p)
+{
+  p.set_id(m_particles.size() + m_staged.size());
+  m_staged.push_back(p);
+}
+
+/*! Add all queued particles to the system in a single pass. 
+ *  Staged particles are new, so they are appended to groups without 
+ *  checking for duplicates. Particles whose molecule id does not refer 
+ *  to an existing molecule each form a new molecule. If nothing else has 
+ *  forced a neighbour list rebuild, the neighbour list can be updated 
+ *  incrementally for the appended particles (see NeighbourList::add_particles).
+ */ 
+void System::commit_particles()
+{
+  if (m_staged.size() == 0) return;
+  int first = m_particles.size();
+  int n_mol = m_molecules.size();
+  m_particles.reserve(first + m_staged.size());
+  for (unsigned int i = 0; i < m_staged.size(); i++)
+  {
+    Particle& p = m_staged[i];
+    p.set_flag(m_current_particle_flag++);
+    p.group_mask = 0;
+    for (list<string>::iterator it = p.groups.begin(); it != p.groups.end(); it++)
+    {
+      m_group[*it]->append_particle(p.get_id());
+      p.set_group_bit(m_group[*it]->get_id());
+    }
+    if (p.boundary) m_boundary.push_back(p.get_id());
+    if (p.molecule < n_mol)
+      m_molecules[p.molecule].push_back(p.get_id());
+    else 
+    {
+      p.molecule = m_molecules.size();
+      m_molecules.push_back(vector<int>(1,p.get_id()));
+    }
+    m_particles.push_back(p);
+  }
+  m_staged.clear();
+  if (!m_force_nlist_rebuild)
+    m_nlist_append = first;
+  m_force_nlist_rebuild = true;
+}
+
 /*! Remove particle from the system
  *  \param id Id of particle to remove
  */ 
 void System::remove_particle(int id)
 {
-  Particle& pi = m_particles[id];
-  int mol_id = pi.molecule;
-  if (pi.boundary)
+  this->remove_particles(vector<int>(1,id));
+}
+
+/*! Remove a set of particles from the system. All data structures (particles, 
+ *  molecules, groups and boundary) are renumbered in a single pass using the 
+ *  map between old and new particle indices.
+ *  \param ids Ids of particles to remove (current ids, in any order)
+ */ 
+void System::remove_particles(const vector<int>& ids)
+{
+  if (ids.size() == 0) return;
+  int N = m_particles.size();
+  vector<bool> removed(N, false);
+  // Relink boundary neighbours (in the old numbering) 
+  for (unsigned int r = 0; r < ids.size(); r++)
   {
-    Particle& pj = m_particles[pi.boundary_neigh[0]];
-    Particle& pk = m_particles[pi.boundary_neigh[1]];
-    pj.boundary_neigh[(pj.boundary_neigh[0] == id) ? 0 : 1] = pk.get_id();
-    pk.boundary_neigh[(pk.boundary_neigh[0] == id) ? 0 : 1] = pj.get_id();
+    int id = ids[r];
+    if (removed[id]) continue;
+    removed[id] = true;
+    Particle& pi = m_particles[id];
+    if (pi.boundary)
+    {
+      Particle& pj = m_particles[pi.boundary_neigh[0]];
+      Particle& pk = m_particles[pi.boundary_neigh[1]];
+      pj.boundary_neigh[(pj.boundary_neigh[0] == id) ? 0 : 1] = pk.get_id();
+      pk.boundary_neigh[(pk.boundary_neigh[0] == id) ? 0 : 1] = pj.get_id();
+    }
   }
-  vector<int>::iterator it_m = find(m_molecules[mol_id].begin(), m_molecules[mol_id].end(),id);
-  m_molecules[mol_id].erase(it_m);
-  if (m_molecules[mol_id].size() == 0)
-    m_molecules.erase(m_molecules.begin() + mol_id);
-  m_particles.erase(m_particles.begin() + id);
-  // Shift down all ids
-  for (unsigned int i = 0; i < m_particles.size(); i++)
+  // Map between old and new particle indices (-1 for removed particles)
+  vector<int> new_idx(N, -1);
+  int n = 0;
+  for (int i = 0; i < N; i++)
+    if (!removed[i])
+      new_idx[i] = n++;
+  // Compact molecules and drop the empty ones
+  vector<int> new_mol(m_molecules.size(), -1);
+  int n_mol = 0;
+  for (unsigned int m = 0; m < m_molecules.size(); m++)
   {
-    Particle& p = m_particles[i];
-    if (p.get_id() > id)
-      p.set_id(p.get_id() - 1);
-    if (p.molecule > mol_id)
-      p.molecule--;
-    if (p.boundary)
+    vector<int>& mol = m_molecules[m];
+    int k = 0;
+    for (unsigned int j = 0; j < mol.size(); j++)
+      if (new_idx[mol[j]] >= 0)
+        mol[k++] = new_idx[mol[j]];
+    mol.erase(mol.begin() + k, mol.end());
+    if (k > 0)
     {
-      if (p.boundary_neigh[0] > id) p.boundary_neigh[0]--;
-      if (p.boundary_neigh[1] > id) p.boundary_neigh[1]--;
+      if (n_mol != static_cast<int>(m)) m_molecules[n_mol].swap(mol);
+      new_mol[m] = n_mol++;
     }
   }
-  for (unsigned int i = 0; i < m_molecules.size(); i++)
+  m_molecules.erase(m_molecules.begin() + n_mol, m_molecules.end());
+  // Compact particles
+  for (int i = 0; i < N; i++)
   {
-    for (unsigned int j = 0; j < m_molecules[i].size(); j++)
-      if (m_molecules[i][j] > mol_id) 
-       m_molecules[i][j]--; 
+    int k = new_idx[i];
+    if (k < 0) continue;
+    if (k != i) m_particles[k] = m_particles[i];
+    Particle& p = m_particles[k];
+    p.set_id(k);
+    p.molecule = new_mol[p.molecule];
+    if (p.boundary)
+    {
+      p.boundary_neigh[0] = new_idx[p.boundary_neigh[0]];
+      p.boundary_neigh[1] = new_idx[p.boundary_neigh[1]];
+    }
   }
+  m_particles.erase(m_particles.begin() + n, m_particles.end());
   // Update all groups
   for(map<string, GroupPtr>::iterator it_g = m_group.begin(); it_g != m_group.end(); it_g++)
-    (*it_g).second->shift(id);
+    (*it_g).second->remap(new_idx);
   
-  vector<int>::iterator it = find(m_boundary.begin(), m_boundary.end(),id);
-  if (it != m_boundary.end()) m_boundary.erase(it);
+  int k = 0;
   for (unsigned int i = 0; i < m_boundary.size(); i++)  
-    if (m_boundary[i] > id) m_boundary[i]--;
+    if (new_idx[m_boundary[i]] >= 0)
+      m_boundary[k++] = new_idx[m_boundary[i]];
+  m_boundary.erase(m_boundary.begin() + k, m_boundary.end());
   
   m_force_nlist_rebuild = true;
+  m_nlist_append = -1;
 }
 
 /*! Change group of the particle
@@ -663,10 +1029,16 @@ void System::change_group(int id, const string& old_group, const string& new_gro
     throw runtime_error("Unknown particle group.");
   }
   else
+  {
     p.groups.erase(it_g);
+    p.clear_group_bit(m_group[old_group]->get_id());
+  }
   
   if (new_group != "all") // It's already in "all"
+  {
     p.add_group(new_group);
+    p.set_group_bit(m_group[new_group]->get_id());
+  }
   
   m_group[old_group]->remove_particle(p.get_id());
   if (new_group != "all") // It's already in "all"
@@ -686,7 +1058,7 @@ void System::zero_cm_momentum(const string& group)
   }
   
   int N = m_group[group]->get_size();
-  vector<int> particles = m_group[group]->get_particles();
+  const vector<int>& particles = m_group[group]->get_particles();
   double vcm_x = 0.0, vcm_y = 0.0, vcm_z = 0.0;
   double tau_cm_x = 0.0, tau_cm_y = 0.0, tau_cm_z = 0.0;
   N = this->size();
@@ -1074,14 +1446,15 @@ void System::apply_periodic(double& dx, double& dy, double& dz)
 //! \param group group name
 bool System::group_ok(const string& group)
 {
-  int N = m_group[group]->get_size();
-  vector<int> particles = m_group[group]->get_particles();
+  GroupPtr g = m_group[group];
+  int N = g->get_size();
+  int gid = g->get_id();
+  const vector<int>& particles = g->get_particles();
   for (int i = 0; i < N; i++)
   {
     int pi = particles[i];
     Particle& p = m_particles[pi];
-    list<string>::iterator it_g = find(p.groups.begin(),p.groups.end(),group);
-    if (it_g == p.groups.end())
+    if (!p.in_group(gid))
     {
       cout << "For group : " << group << endl;
       cout << p;
@@ -1099,32 +1472,32 @@ void System::enforce_periodic(Particle& p)
   {
     if (p.x <= m_box->xlo) 
     {
-      p.x += m_box->Lx;
+      p.move(m_box->Lx, 0.0, 0.0);
       p.ix--;
     }
     else if (p.x > m_box->xhi)
     {
-      p.x -= m_box->Lx;
+      p.move(-m_box->Lx, 0.0, 0.0);
       p.ix++;
     }
     if (p.y <= m_box->ylo)
     {
-      p.y += m_box->Ly;
+      p.move(0.0, m_box->Ly, 0.0);
       p.iy--;
     }
     else if (p.y > m_box->yhi)
     {
-      p.y -= m_box->Ly;
+      p.move(0.0, -m_box->Ly, 0.0);
       p.iy++;
     }
     if (p.z <= m_box->zlo)
     {
-      p.z += m_box->Lz;
+      p.move(0.0, 0.0, m_box->Lz);
       p.iz--;
     }
     else if (p.z > m_box->zhi)
     {
-      p.z -= m_box->Lz;
+      p.move(0.0, 0.0, -m_box->Lz);
       p.iz++;
     }
   }
@@ -1165,7 +1538,11 @@ void System::update_mesh()
       */
       converged = converged && m_mesh.equiangulate();
       //converged = converged && m_mesh.remove_edge_triangles();
-      m_mesh.update_dual_mesh();
+      // Vertices moved only before the first pass; afterwards only faces changed by flips need updating
+      if (iter == 0)
+        m_mesh.update_dual_mesh();
+      else
+        m_mesh.update_dirty_faces();
       m_mesh.update_face_properties();
       if (m_mesh.has_obtuse_boundary())
         this->set_force_nlist_rebuild(true);
@@ -1177,12 +1554,7 @@ void System::update_mesh()
       cout << "Exceeded maximum number of iterations in boundary build. Most likely something is wrong with input paramters. Results will not be reliable." << endl;
       throw runtime_error("Exceeded maximum number of iterations in boundary build.");
     }
-    for (int i = 0; i < m_mesh.size(); i++)
-    {
-      m_mesh.order_dual(i);
-      m_mesh.dual_perimeter(i);
-      m_mesh.dual_area(i); 
-    }
+    m_mesh.update_dual_vertices();
   }
 }
 
@@ -1206,4 +1578,222 @@ void System::molecule_cm(int mol_id, double& xcm, double& ycm, double& zcm)
   }
   xcm = xcm/M + p0.x; ycm = ycm/M + p0.y; zcm = zcm/M + p0.z;
   this->apply_periodic(xcm,ycm,zcm);
-}
\ No newline at end of file
+}
+//! Write all persistent data of a particle into a checkpoint 
+//! \note Per particle energies, force types and stress are recomputed in each step and are not stored
+//! \param ckp checkpoint writer
+//! \param p particle to write
+static void write_particle(CheckpointWriter& ckp, Particle& p)
+{
+  ckp.write(p.get_id());  ckp.write(p.get_type());  ckp.write(p.get_radius());  ckp.write(p.get_length());
+  ckp.write(p.get_A0());  ckp.write(p.get_flag());  ckp.write(p.get_parent());
+  double x, y, z;   // position is stored at full precision regardless of Scalar
+  p.get_position(x, y, z);
+  ckp.write(x);  ckp.write(y);  ckp.write(z);
+  ckp.write(p.vx);  ckp.write(p.vy);  ckp.write(p.vz);
+  ckp.write<double>(p.fx);  ckp.write<double>(p.fy);  ckp.write<double>(p.fz);
+  ckp.write(p.tau_x);  ckp.write(p.tau_y);  ckp.write(p.tau_z);
+  ckp.write(p.nx);  ckp.write(p.ny);  ckp.write(p.nz);
+  ckp.write(p.ix);  ckp.write(p.iy);  ckp.write(p.iz);
+  ckp.write(p.Nx);  ckp.write(p.Ny);  ckp.write(p.Nz);
+  ckp.write(p.omega);  ckp.write(p.age);  ckp.write(p.A0);  ckp.write(p.mass);
+  ckp.write(p.boundary);  ckp.write(p.in_tissue);
+  ckp.write(p.coordination);  ckp.write(p.molecule);  ckp.write(p.bind);  ckp.write(p.unbind);
+  ckp.write<boost::uint32_t>(p.groups.size());
+  for (list<string>::iterator it = p.groups.begin(); it != p.groups.end(); it++)
+    ckp.write_string(*it);
+  ckp.write_vector(p.bonds);
+  ckp.write_vector(p.angles);
+  ckp.write_vector(p.boundary_neigh);
+}
+
+//! Read a particle from a checkpoint
+//! \param ckp checkpoint reader
+//! \return particle
+static Particle read_particle(CheckpointReader& ckp)
+{
+  int id, type, flag, parent;
+  double r, l, A0;
+  ckp.read(id);  ckp.read(type);  ckp.read(r);  ckp.read(l);
+  ckp.read(A0);  ckp.read(flag);  ckp.read(parent);
+  Particle p(id, type, r);
+  p.set_length(l);  p.set_default_area(A0);  p.set_flag(flag);  p.set_parent(parent);
+  double x, y, z, fx, fy, fz;   // stored in double precision regardless of Scalar
+  ckp.read(x);  ckp.read(y);  ckp.read(z);
+  ckp.read(p.vx);  ckp.read(p.vy);  ckp.read(p.vz);
+  ckp.read(fx);  ckp.read(fy);  ckp.read(fz);
+  p.set_position(x, y, z);
+  p.fx = fx;  p.fy = fy;  p.fz = fz;
+  ckp.read(p.tau_x);  ckp.read(p.tau_y);  ckp.read(p.tau_z);
+  ckp.read(p.nx);  ckp.read(p.ny);  ckp.read(p.nz);
+  ckp.read(p.ix);  ckp.read(p.iy);  ckp.read(p.iz);
+  ckp.read(p.Nx);  ckp.read(p.Ny);  ckp.read(p.Nz);
+  ckp.read(p.omega);  ckp.read(p.age);  ckp.read(p.A0);  ckp.read(p.mass);
+  ckp.read(p.boundary);  ckp.read(p.in_tissue);
+  ckp.read(p.coordination);  ckp.read(p.molecule);  ckp.read(p.bind);  ckp.read(p.unbind);
+  boost::uint32_t n_groups;
+  ckp.read(n_groups);
+  for (boost::uint32_t g = 0; g < n_groups; g++)
+  {
+    string name;
+    ckp.read_string(name);
+    p.groups.push_back(name);
+  }
+  ckp.read_vector(p.bonds);
+  ckp.read_vector(p.angles);
+  ckp.read_vector(p.boundary_neigh);
+  return p;
+}
+
+/*! Save entire system into the "system" section of a checkpoint. 
+ *  Stored are the simulation box, all particles, bonds, angles, groups (in their 
+ *  current order), exclusions, molecules and boundary information. 
+ *  \note Mesh is not stored since the neighbour list rebuilds it from 
+ *  particle positions and boundary neighbours.
+ *  \param ckp checkpoint writer
+ */
+void System::write_checkpoint(CheckpointWriter& ckp)
+{
+  if (m_staged.size() > 0)
+  {
+    m_msg->msg(Messenger::ERROR,"Cannot write checkpoint while there are particles waiting to be added to the system.");
+    throw runtime_error("Checkpoint with staged particles.");
+  }
+  ckp.begin_section("system");
+  ckp.write(m_box->xlo);  ckp.write(m_box->xhi);
+  ckp.write(m_box->ylo);  ckp.write(m_box->yhi);
+  ckp.write(m_box->zlo);  ckp.write(m_box->zhi);
+  ckp.write(m_periodic);  ckp.write(m_time_step);  ckp.write(m_dt);
+  ckp.write(m_n_types);  ckp.write(m_n_bond_types);  ckp.write(m_n_angle_types);
+  ckp.write(m_current_particle_flag);  ckp.write(m_boundary_type);  ckp.write(m_max_mesh_iter);
+  ckp.write(m_has_exclusions);  ckp.write(m_has_boundary_neighbours);
+  // Particles
+  ckp.write<boost::uint64_t>(m_particles.size());
+  for (unsigned int i = 0; i < m_particles.size(); i++)
+    write_particle(ckp, m_particles[i]);
+  // Bonds and angles
+  ckp.write<boost::uint64_t>(m_bonds.size());
+  for (unsigned int i = 0; i < m_bonds.size(); i++)
+  {
+    Bond& b = m_bonds[i];
+    ckp.write(b.id);  ckp.write(b.type);  ckp.write(b.i);  ckp.write(b.j);
+  }
+  ckp.write<boost::uint64_t>(m_angles.size());
+  for (unsigned int i = 0; i < m_angles.size(); i++)
+  {
+    Angle& a = m_angles[i];
+    ckp.write(a.id);  ckp.write(a.type);  ckp.write(a.i);  ckp.write(a.j);  ckp.write(a.k);
+  }
+  // Groups
+  ckp.write(m_num_groups);
+  ckp.write<boost::uint32_t>(m_group.size());
+  for (map<string, GroupPtr>::iterator it = m_group.begin(); it != m_group.end(); it++)
+  {
+    ckp.write_string((*it).first);
+    ckp.write((*it).second->get_id());
+    ckp.write_vector((*it).second->get_particles());
+  }
+  // Exclusions, molecules and boundary
+  ckp.write<boost::uint64_t>(m_exclusions.size());
+  for (unsigned int i = 0; i < m_exclusions.size(); i++)
+    ckp.write_vector(m_exclusions[i]);
+  ckp.write<boost::uint64_t>(m_molecules.size());
+  for (unsigned int i = 0; i < m_molecules.size(); i++)
+    ckp.write_vector(m_molecules[i]);
+  ckp.write_vector(m_boundary);
+  ckp.end_section();
+}
+
+/*! Construct the system from the "system" section of a checkpoint 
+ *  (see write_checkpoint). Simulation box is reset to the stored one. 
+ *  \param ckp checkpoint reader
+ *  \param msg Pointer to the Messenger object
+ *  \param box Pointer to the simulation box object
+ */
+System::System(CheckpointReader& ckp, MessengerPtr msg, BoxPtr box) : m_msg(msg), 
+                                                                     m_box(box), 
+                                                                     m_mesh(Mesh()),
+                                                                     m_periodic(false),
+                                                                     m_run_step(0),
+                                                                     m_force_nlist_rebuild(false),
+                                                                     m_nlist_rescale(1.0),
+                                                                     m_nlist_append(-1),
+                                                                     m_record_force_type(false)
+{
+  m_msg->msg(Messenger::INFO,"Reading system from checkpoint file: "+ckp.get_name());
+  m_msg->write_config("system.checkpoint_file",ckp.get_name());
+  ckp.open_section("system");
+  double xlo, xhi, ylo, yhi, zlo, zhi;
+  ckp.read(xlo);  ckp.read(xhi);
+  ckp.read(ylo);  ckp.read(yhi);
+  ckp.read(zlo);  ckp.read(zhi);
+  *m_box = Box(xlo, xhi, ylo, yhi, zlo, zhi);
+  ckp.read(m_periodic);  ckp.read(m_time_step);  ckp.read(m_dt);  m_dt_current = m_dt;
+  ckp.read(m_n_types);  ckp.read(m_n_bond_types);  ckp.read(m_n_angle_types);
+  ckp.read(m_current_particle_flag);  ckp.read(m_boundary_type);  ckp.read(m_max_mesh_iter);
+  ckp.read(m_has_exclusions);  ckp.read(m_has_boundary_neighbours);
+  // Particles
+  boost::uint64_t N;
+  ckp.read(N);
+  m_particles.reserve(N);
+  for (boost::uint64_t i = 0; i < N; i++)
+    m_particles.push_back(read_particle(ckp));
+  // Bonds and angles
+  boost::uint64_t n;
+  ckp.read(n);
+  m_bonds.reserve(n);
+  for (boost::uint64_t i = 0; i < n; i++)
+  {
+    int id, type, pi, pj;
+    ckp.read(id);  ckp.read(type);  ckp.read(pi);  ckp.read(pj);
+    m_bonds.push_back(Bond(id, type, pi, pj));
+  }
+  ckp.read(n);
+  m_angles.reserve(n);
+  for (boost::uint64_t i = 0; i < n; i++)
+  {
+    int id, type, pi, pj, pk;
+    ckp.read(id);  ckp.read(type);  ckp.read(pi);  ckp.read(pj);  ckp.read(pk);
+    m_angles.push_back(Angle(id, type, pi, pj, pk));
+  }
+  // Groups (particle order within each group is preserved)
+  boost::uint32_t n_groups;
+  ckp.read(m_num_groups);
+  ckp.read(n_groups);
+  for (boost::uint32_t g = 0; g < n_groups; g++)
+  {
+    string name;
+    int gid;
+    vector<int> particles;
+    ckp.read_string(name);
+    ckp.read(gid);
+    ckp.read_vector(particles);
+    m_group[name] = make_shared<Group>(Group(gid, name));
+    for (unsigned int i = 0; i < particles.size(); i++)
+    {
+      if (particles[i] < 0 || particles[i] >= static_cast<int>(N))
+      {
+        m_msg->msg(Messenger::ERROR,"Group "+name+" in checkpoint file "+ckp.get_name()+" contains non-existent particle.");
+        throw runtime_error("Corrupted checkpoint file.");
+      }
+      m_group[name]->append_particle(particles[i]);
+      m_particles[particles[i]].set_group_bit(gid);
+    }
+  }
+  // Exclusions, molecules and boundary
+  ckp.read(n);
+  m_exclusions.resize(n);
+  for (boost::uint64_t i = 0; i < n; i++)
+    ckp.read_vector(m_exclusions[i]);
+  ckp.read(n);
+  m_molecules.resize(n);
+  for (boost::uint64_t i = 0; i < n; i++)
+    ckp.read_vector(m_molecules[i]);
+  ckp.read_vector(m_boundary);
+  
+  m_msg->msg(Messenger::INFO,"Read data for "+lexical_cast<string>(m_particles.size())+" particles, "+lexical_cast<string>(m_bonds.size())+" bonds and "+lexical_cast<string>(m_angles.size())+" angles at time step "+lexical_cast<string>(m_time_step)+".");
+  m_msg->write_config("system.n_particles",lexical_cast<string>(m_particles.size()));
+  m_msg->write_config("system.n_types",lexical_cast<string>(m_n_types));
+  
+  this->disable_per_particle_eng();
+}
@@ -55,6 +55,7 @@
 #include "group.hpp"
 #include "defaults.hpp"
 #include "mesh.hpp"
+#include "checkpoint.hpp"
 
 #include "parse_parameters.hpp"
 
@@ -86,6 +87,9 @@ public:
   //! Construct the system 
   System(const string&, MessengerPtr, BoxPtr);
   
+  //! Construct the system from a checkpoint
+  System(CheckpointReader&, MessengerPtr, BoxPtr);
+  
   ~System() { m_particles.clear(); m_bonds.clear(); m_angles.clear(); }
   
   //! Get system size
@@ -185,8 +189,13 @@ public:
   bool get_force_nlist_rebuild() { return m_force_nlist_rebuild; }
   
   //! Set the force_nlist_rebuild flag
+  //! \note Forcing the rebuild also disables incremental neighbour list update
   //! \param val new value of the flag
-  void set_force_nlist_rebuild(bool val) { m_force_nlist_rebuild = val; }
+  void set_force_nlist_rebuild(bool val) 
+  { 
+    m_force_nlist_rebuild = val; 
+    if (val) m_nlist_append = -1;
+  }
   
   //! Generate a group of particles
   void make_group(const string, pairs_type&);
@@ -212,9 +221,21 @@ public:
   //! Add particle to the system
   void add_particle(Particle&);
   
+  //! Queue particle for insertion into the system
+  void stage_particle(Particle&);
+  
+  //! Get number of particles waiting for insertion
+  int num_staged() { return m_staged.size(); }
+  
+  //! Add all queued particles to the system
+  void commit_particles();
+  
   //! Remove particle from the system
   void remove_particle(int);
   
+  //! Remove a set of particles from the system
+  void remove_particles(const vector<int>&);
+  
   //! Move particle from one group to the other
   void change_group(int, const string&, const string&);
     
@@ -268,6 +289,16 @@ public:
   //! Apply period boundary conditions on a quantity 
   void apply_periodic(double&, double&, double&);
   
+#ifdef SINGLE_PRECISION
+  //! Apply period boundary conditions on single precision coordinates
+  void apply_periodic(Scalar& x, Scalar& y, Scalar& z)
+  {
+    double dx = x, dy = y, dz = z;
+    this->apply_periodic(dx,dy,dz);
+    x = dx;  y = dy;  z = dz;
+  }
+#endif
+  
   //! Make sure that all group information on particles matches group information in the lists
   bool group_ok(const string&);
   
@@ -281,15 +312,31 @@ public:
   //! Get value of the n_list rescale parameter
   double get_nlist_rescale() { return m_nlist_rescale; }
   
+  //! Set index of the first particle added since the last neighbour list build
+  //! \param first index of the first added particle (-1 if the list cannot be updated incrementally)
+  void set_nlist_append(int first) { m_nlist_append = first; }
+  
+  //! Get index of the first particle added since the last neighbour list build
+  //! \return -1 if the neighbour list has to be fully rebuilt
+  int get_nlist_append() { return m_nlist_append; }
+  
   //! Update mesh information for tissue simulations
   void update_mesh();
   
   //! Set the value of the integrator time step
   //! \param dt step size
-  void set_integrator_step(double dt)  { m_dt = dt; }
+  void set_integrator_step(double dt)  { m_dt = dt; m_dt_current = dt; }
   
   //! Get the value of the integrator time step
-  double get_integrator_step() { return m_dt; }
+  //! \note With adaptive time step this is the size of the step actually made, not the one set in the input file
+  double get_integrator_step() { return m_dt_current; }
+  
+  //! Set the size of the step actually made (used by integrators with adaptive time step)
+  //! \param dt step size
+  void set_current_step(double dt) { m_dt_current = dt; }
+  
+  //! Get the value of the integrator time step set in the input file
+  double get_nominal_step() { return m_dt; }
   
   //! Set the number of mesh iteration 
   //! \param iter number of iteration 
@@ -325,6 +372,9 @@ public:
 
   //! Get value of the record_force_type flag
   bool record_force_type() { return m_record_force_type; }
+  
+  //! Save entire system into a checkpoint
+  void write_checkpoint(CheckpointWriter&);
     
 private:
   
@@ -342,11 +392,14 @@ private:
   int m_num_groups;                     //!< Total number of groups in the system
   bool m_force_nlist_rebuild;           //!< Forced rebuilding of neighbour list
   double m_nlist_rescale;               //!< Rescale neighbour list cutoff by this much
+  int m_nlist_append;                   //!< Particles from this index on were only appended since the last neighbour list build (-1 if not applicable)
+  vector<Particle> m_staged;            //!< Particles waiting to be added to the system
   int m_n_types;                        //!< Number of different particle types (used to set pair parameters) 
   int m_n_bond_types;                   //!< Number of different bond types
   int m_n_angle_types;                  //!< Number of different angle types
   int m_current_particle_flag;          //!< Keeps track of the last particle flag (distinct immutable id) of all particles. For bookkeeping. Clumsy as hell!  
   double m_dt;                          //!< This is a global integrator step used by all integrators (\note: it can be overwritten by a specific integrator)
+  double m_dt_current;                  //!< Size of the step actually made (differs from m_dt if integrator uses adaptive time step)
   bool m_has_exclusions;                //!< If true, there are bonded interactions in the system and therefore those are accompanied with exclusions
   int m_max_mesh_iter;                  //!< Maximum number of iterations when cleaning up boundaries in the tissue simulations
   vector<vector<int> > m_exclusions;    //!< Which particles to be excluded from computing non bonded interactions (basically everything in bonds and angles)
@@ -355,6 +408,9 @@ private:
   bool m_has_boundary_neighbours;       //!< If true, systems contains boundary neighbours (used in cells simulations)
   vector<vector<int> > m_molecules;     //!< List of all particles ids in a given molecule
   bool m_record_force_type;             //!< If true, for each particle record each force type that acts on it
+  
+  //! Read input file in the "keys:" format using the fast (memory mapped, parallel) reader
+  bool read_keys_fast(const string&, bool&, vector<int>&);
    
 };
 
@@ -93,6 +93,30 @@ struct Vertex
    if (!p.in_tissue) attached = false;
   }
   
+  //! Reset vertex to the state of a freshly constructed one, 
+  //! but keep already allocated storage for its star
+  //! \param p particle
+  void reset(Particle& p)
+  {
+    if (p.Nx == 0.0 && p.Ny == 0.0 && p.Nz == 0.0)
+      throw runtime_error("Surface normal for each mesh vertex has to non-zero."); 
+    id = p.get_id();
+    type = p.get_type();
+    r = Vector3d(p.x,p.y,p.z);
+    N = Vector3d(p.Nx,p.Ny,p.Nz);
+    z = 0;
+    n_edges = 0;
+    n_faces = 0;
+    boundary = false;
+    ordered = false;
+    attached = p.in_tissue;
+    neigh.clear();
+    edges.clear();
+    faces.clear();
+    dual.clear();
+    dual_neighbour_map.clear();
+  }
+  
   ~Vertex()
   {
     neigh.clear();           
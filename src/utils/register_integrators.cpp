@@ -45,6 +45,8 @@ void register_integrators(IntegratorMap& integrators)
   integrators["brownian_rod"] = boost::factory<IntegratorBrownianRodPtr>();
   // Register Brownian dynamics integrator for particle position with the integrators class factory
   integrators["brownian_pos"] = boost::factory<IntegratorBrownianPosPtr>();
+  // Register implicit Brownian dynamics integrator for particle position with the integrators class factory
+  integrators["brownian_implicit"] = boost::factory<IntegratorBrownianImplicitPtr>();
   // Register Brownian dynamics integrator for alignment with the integrators class factory
   integrators["brownian_align"] = boost::factory<IntegratorBrownianAlignPtr>();
   // Register Langevin dynamics integrator for particle positions with the integrators class factory
@@ -53,4 +55,6 @@ void register_integrators(IntegratorMap& integrators)
   integrators["fire"] = boost::factory<IntegratorFIREPtr>();
   // Register Sepulveda minimisaton integrator with the integrators class factory
   integrators["sepulveda"] = boost::factory<IntegratorSepulvedaPtr>();
+  // Register RESPA multiple time step integrator with the integrators class factory
+  integrators["respa"] = boost::factory<IntegratorRESPAPtr>();
 }
@@ -29,10 +29,26 @@
 
 #include "rng.hpp"
 
+#include <cstring>
+
+#define PHILOX_M0 0xD2511F53u         //!< Philox multiplier for the first word pair
+#define PHILOX_M1 0xCD9E8D57u         //!< Philox multiplier for the second word pair
+#define PHILOX_W0 0x9E3779B9u         //!< Philox key increment (golden ratio)
+#define PHILOX_W1 0xBB67AE85u         //!< Philox key increment (sqrt(3)-1)
+#define PHILOX_KEY_1 0x53414D4Fu      //!< Second word of the Philox key 
+#define PHILOX_2POW_M32 2.3283064365386963e-10  //!< 2^-32 used to convert 32 bit words to doubles
+
 //! Initialize RNG (GSL)
 //! \param seed initial seed for the random number generator
-RNG::RNG(int seed) : m_seed(seed)
+//! \param salt name of the component using the generator (hashed into the Philox key)
+RNG::RNG(int seed, const string& salt) : m_seed(seed), m_salt(2166136261u)
 {
+  // FNV-1a hash of the salt
+  for (unsigned int i = 0; i < salt.size(); i++)
+  {
+    m_salt ^= static_cast<unsigned char>(salt[i]);
+    m_salt *= 16777619u;
+  }
   gsl_rng_env_setup();
   GSL_RANDOM_TYPE = gsl_rng_default;
   GSL_RANDOM_GENERATOR = gsl_rng_alloc(GSL_RANDOM_TYPE);
@@ -68,5 +84,150 @@ int RNG::lrnd(int N)
   return static_cast<int>(N*drnd());
 }
 
+//! Get a counter-based random number between 0 and 1 drawn from an uniform distribution.
+//! The same set of arguments (together with the seed) always returns the same number.
+//! \param flag unique particle flag 
+//! \param step time step 
+//! \param stream index of the random stream (distinguishes several draws per particle per step)
+//! \return random number in the interval (0,1)
+double RNG::drnd(int flag, int step, int stream)
+{
+  uint32_t r[4];
+  this->philox(flag, step, stream, r);
+  return (r[0] + 0.5)*PHILOX_2POW_M32;
+}
+
+//! Return a counter-based random number from a Gaussian distribution with a given standard deviation.
+//! Uses the Box-Muller transform of a single Philox block.
+//! \param sigma standard deviation 
+//! \param flag unique particle flag 
+//! \param step time step 
+//! \param stream index of the random stream
+double RNG::gauss_rng(double sigma, int flag, int step, int stream)
+{
+  double g1, g2;
+  this->gauss_rng(sigma, flag, step, stream, g1, g2);
+  return g1;
+}
+
+//! Return two independent counter-based random numbers from a Gaussian distribution with a given standard deviation.
+//! \param sigma standard deviation 
+//! \param flag unique particle flag 
+//! \param step time step 
+//! \param stream index of the random stream
+//! \param g1 first Gaussian number (on return)
+//! \param g2 second Gaussian number (on return)
+void RNG::gauss_rng(double sigma, int flag, int step, int stream, double& g1, double& g2)
+{
+  uint32_t r[4];
+  this->philox(flag, step, stream, r);
+  double u1 = (r[0] + 0.5)*PHILOX_2POW_M32;
+  double u2 = (r[1] + 0.5)*PHILOX_2POW_M32;
+  double rad = sigma*std::sqrt(-2.0*std::log(u1));
+  double phi = 2.0*M_PI*u2;
+  g1 = rad*std::cos(phi);
+  g2 = rad*std::sin(phi);
+}
+
+//! Fill an array with counter-based random numbers from a Gaussian distribution with a given standard deviation.
+//! Four numbers are generated for each particle flag from a single Philox block, i.e. 
+//! g[4*i], ..., g[4*i+3] belong to the particle with flag flags[i]. The first two numbers 
+//! are identical to those returned by the single-particle version for the same arguments.
+//! Generation is split into two passes (integer Philox rounds followed by the Box-Muller transform) 
+//! over contiguous arrays so that compiler can vectorise both loops.
+//! \param sigma standard deviation 
+//! \param flags list of unique particle flags
+//! \param step time step 
+//! \param stream index of the random stream
+//! \param g array of Gaussian numbers (on return, resized to 4*flags.size())
+void RNG::gauss_rng(double sigma, const vector<int>& flags, int step, int stream, vector<double>& g)
+{
+  int N = flags.size();
+  int M = 2*N;
+  m_uniform.resize(4*N);
+  g.resize(4*N);
+  if (N == 0)
+    return;
+  double* u = &m_uniform[0];
+  double* out = &g[0];
+  #pragma omp parallel for
+  for (int i = 0; i < N; i++)
+  {
+    uint32_t r[4];
+    this->philox(flags[i], step, stream, r);
+    u[4*i]   = (r[0] + 0.5)*PHILOX_2POW_M32;
+    u[4*i+1] = (r[1] + 0.5)*PHILOX_2POW_M32;
+    u[4*i+2] = (r[2] + 0.5)*PHILOX_2POW_M32;
+    u[4*i+3] = (r[3] + 0.5)*PHILOX_2POW_M32;
+  }
+  #pragma omp parallel for
+  for (int j = 0; j < M; j++)
+  {
+    double rad = sigma*std::sqrt(-2.0*std::log(u[2*j]));
+    double phi = 2.0*M_PI*u[2*j+1];
+    out[2*j]   = rad*std::cos(phi);
+    out[2*j+1] = rad*std::sin(phi);
+  }
+}
+
+//! Save generator state into a checkpoint. Counter-based numbers 
+//! are fully determined by the seed, so only the state of the sequential 
+//! (GSL) generator needs to be stored.
+//! \param ckp checkpoint writer 
+void RNG::write_checkpoint(CheckpointWriter& ckp) const
+{
+  ckp.write<int>(m_seed);
+  ckp.write_string(gsl_rng_name(GSL_RANDOM_GENERATOR));
+  const char* c = static_cast<const char*>(gsl_rng_state(GSL_RANDOM_GENERATOR));
+  ckp.write_vector(vector<char>(c, c + gsl_rng_size(GSL_RANDOM_GENERATOR)));
+}
+
+//! Restore generator state from a checkpoint. State is restored only if 
+//! the generator has been seeded with the same seed and is of the same type as 
+//! the stored one. 
+//! \param ckp checkpoint reader (positioned at the generator state)
+//! \return true if the state has been restored 
+bool RNG::read_checkpoint(CheckpointReader& ckp)
+{
+  int seed;
+  string name;
+  vector<char> state;
+  ckp.read(seed);
+  ckp.read_string(name);
+  ckp.read_vector(state);
+  if (seed != m_seed || name != gsl_rng_name(GSL_RANDOM_GENERATOR) || state.size() != gsl_rng_size(GSL_RANDOM_GENERATOR))
+    return false;
+  if (state.size() > 0)
+    memcpy(gsl_rng_state(GSL_RANDOM_GENERATOR), &state[0], state.size());
+  return true;
+}
 
+// Private methods
 
+//! Compute one Philox4x32-10 block. Counter is (flag, step, stream, 0) 
+//! and the key is derived from the seed and the component salt.
+//! \param flag unique particle flag 
+//! \param step time step 
+//! \param stream index of the random stream
+//! \param r array of four random words (on return)
+void RNG::philox(int flag, int step, int stream, uint32_t* r)
+{
+  uint32_t k0 = static_cast<uint32_t>(m_seed), k1 = PHILOX_KEY_1 ^ m_salt;
+  r[0] = static_cast<uint32_t>(flag);
+  r[1] = static_cast<uint32_t>(step);
+  r[2] = static_cast<uint32_t>(stream);
+  r[3] = 0;
+  for (int round = 0; round < 10; round++)
+  {
+    uint64_t p0 = static_cast<uint64_t>(PHILOX_M0)*r[0];
+    uint64_t p1 = static_cast<uint64_t>(PHILOX_M1)*r[2];
+    uint32_t hi0 = static_cast<uint32_t>(p0 >> 32), lo0 = static_cast<uint32_t>(p0);
+    uint32_t hi1 = static_cast<uint32_t>(p1 >> 32), lo1 = static_cast<uint32_t>(p1);
+    r[0] = hi1 ^ r[1] ^ k0;
+    r[1] = lo1;
+    r[2] = hi0 ^ r[3] ^ k1;
+    r[3] = lo0;
+    k0 += PHILOX_W0;
+    k1 += PHILOX_W1;
+  }
+}
@@ -30,20 +30,39 @@
 #ifndef __RNG_H__
 #define __RNG_H__
 
+#include <cmath>
+#include <vector>
+#include <string>
+
 #include <boost/shared_ptr.hpp>
+#include <boost/cstdint.hpp>
 
 #include <gsl/gsl_rng.h>
 #include <gsl/gsl_randist.h>
 
+#include "checkpoint.hpp"
+
 using boost::shared_ptr;
+using boost::uint32_t;
+using boost::uint64_t;
+using std::vector;
+using std::string;
 
-/*! Class handles random numbers in the system */
+/*! Class handles random numbers in the system. 
+ *  Apart from the sequential (stateful) GSL generator, it provides counter-based 
+ *  random numbers generated with the Philox4x32-10 algorithm of 
+ *  J. K. Salmon, et al., Proc. SC11 (2011). Counter-based numbers are pure functions 
+ *  of (seed, particle flag, time step, stream) and therefore do not depend on the 
+ *  order in which particles are visited or on the number of threads.
+ *  Each component passes its name as a salt, so that components sharing a seed 
+ *  (e.g., the default seed 0) draw from independent streams.
+ */
 class RNG
 {
 public:
   
   //! Constructor (initialize random number generator)
-  RNG(int);
+  RNG(int, const string& = "");
   
   //! Destructor
   ~RNG();
@@ -56,10 +75,37 @@ public:
   
   //! Return a Gaussian distributed number with a given standard deviation
   double gauss_rng(double);
+  
+  //! Return counter-based random number between 0 and 1
+  double drnd(int, int, int);
+  
+  //! Return counter-based Gaussian distributed number with a given standard deviation
+  double gauss_rng(double, int, int, int);
+  
+  //! Return a pair of counter-based Gaussian distributed numbers with a given standard deviation
+  void gauss_rng(double, int, int, int, double&, double&);
+  
+  //! Fill an array with counter-based Gaussian numbers (four per particle)
+  void gauss_rng(double, const vector<int>&, int, int, vector<double>&);
+  
+  //! Get random number generator seed
+  int get_seed() const { return m_seed; }
+  
+  //! Save generator state into a checkpoint
+  void write_checkpoint(CheckpointWriter&) const;
+  
+  //! Restore generator state from a checkpoint
+  bool read_checkpoint(CheckpointReader&);
 
 private:
   
+  //! Philox4x32-10 block (four 32 bit random words) for a given counter
+  void philox(int, int, int, uint32_t*);
+  
+  vector<double> m_uniform;   //!< Scratch array for uniform numbers used in batched generation
+  
   int m_seed;   //!< Random number generator seed
+  uint32_t m_salt;   //!< Salt mixed into the Philox key (separates streams of different components)
   const gsl_rng_type* GSL_RANDOM_TYPE;  //!< Pointer to the gsl_rng_type structure which handles the RNG type
   gsl_rng* GSL_RANDOM_GENERATOR;        //!< Pointer which holds the actual random number generator
 
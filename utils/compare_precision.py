@@ -0,0 +1,81 @@
+# ***************************************************************************
+# *
+# *  Copyright (C) 2013-2016 University of Dundee
+# *  All rights reserved. 
+# *
+# *  This file is part of SAMoS (Soft Active Matter on Surfaces) program.
+# *
+# *  SAMoS is free software; you can redistribute it and/or modify
+# *  it under the terms of the GNU General Public License as published by
+# *  the Free Software Foundation; either version 2 of the License, or
+# *  (at your option) any later version.
+# *
+# *  SAMoS is distributed in the hope that it will be useful,
+# *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+# *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# *  GNU General Public License for more details.
+# *
+# *  You should have received a copy of the GNU General Public License
+# *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+# *
+# *****************************************************************************
+
+# Statistical validation of the single precision build (compiled with -DENABLE_SINGLE_PRECISION=ON).
+# Run the same input script with the double and the single precision executable and
+# compare the two sets of full dumps frame by frame. Individual trajectories diverge
+# (dynamics is chaotic and noisy), so only per-frame ensemble averages are compared.
+# For each observable, the difference of the means is measured in units of its standard error.
+
+import sys
+import argparse
+from glob import glob
+import numpy as np
+
+from read_data import *
+
+parser = argparse.ArgumentParser()
+parser.add_argument("-d", "--double", type=str, help="dump files of the double precision run (glob pattern, quoted)")
+parser.add_argument("-s", "--single", type=str, help="dump files of the single precision run (glob pattern, quoted)")
+parser.add_argument("-t", "--tolerance", type=float, default=4.0, help="largest accepted difference of means (in standard errors)")
+args = parser.parse_args()
+
+double_files = sorted(glob(args.double))
+single_files = sorted(glob(args.single))
+if len(double_files) == 0 or len(double_files) != len(single_files):
+	print "Error: Need the same (non-zero) number of dump files for both runs. Found " + str(len(double_files)) + " and " + str(len(single_files)) + "."
+	sys.exit(1)
+
+def observables(data):
+	obs = {}
+	keys = data.keys
+	if keys.has_key('vx'):
+		obs['speed'] = np.sqrt(np.array(data.data[keys['vx']])**2 + np.array(data.data[keys['vy']])**2 + np.array(data.data[keys['vz']])**2)
+	if keys.has_key('fx'):
+		obs['force'] = np.sqrt(np.array(data.data[keys['fx']])**2 + np.array(data.data[keys['fy']])**2 + np.array(data.data[keys['fz']])**2)
+	if keys.has_key('x'):
+		for c in ['x','y','z']:
+			obs[c] = np.array(data.data[keys[c]])
+	return obs
+
+worst = 0.0
+print "%6s %8s %14s %14s %8s" % ('frame', 'quantity', 'mean (double)', 'mean (single)', 'z')
+for frame, (fd, fs) in enumerate(zip(double_files, single_files)):
+	obs_d = observables(ReadData(fd))
+	obs_s = observables(ReadData(fs))
+	for name in sorted(obs_d.keys()):
+		if not obs_s.has_key(name):
+			continue
+		a, b = obs_d[name], obs_s[name]
+		err = np.sqrt(np.var(a)/len(a) + np.var(b)/len(b))
+		if err > 0.0:
+			z = abs(np.mean(a) - np.mean(b))/err
+		else:
+			z = 0.0 if np.mean(a) == np.mean(b) else float('inf')
+		worst = max(worst, z)
+		print "%6d %8s %14.6e %14.6e %8.3f" % (frame, name, np.mean(a), np.mean(b), z)
+
+print "Largest deviation " + str(worst) + " standard errors (tolerance " + str(args.tolerance) + ")."
+if worst > args.tolerance:
+	print "Single precision run is NOT statistically consistent with the double precision run."
+	sys.exit(1)
+print "Single precision run is statistically consistent with the double precision run."